@@ -0,0 +1,36 @@
+/*
+* Copyright (c) 2025 InterDigital CE Patent Holdings SASU
+* Licensed under the License terms of 5GMAG software (the "License").
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at https://www.5g-mag.com/license .
+* Unless required by applicable law or agreed to in writing, software distributed under the License is
+* distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and limitations under the License.
+*/
+
+#pragma once
+
+#include <common/misc/span.h>
+#include <cstdint>
+#include <vector>
+
+// Syntax and semantics of ISO/IEC 23008-2 (HEVC), restricted to the access unit boundaries and picture order counts
+namespace hevc
+{
+struct AccessUnit
+{
+    // In place in the bitstream, from the start code of its first NAL unit
+    common::misc::ByteSpan data;
+    // Coded video sequence of the picture, counted from the start of the bitstream
+    std::uint32_t cvsIdx{};
+    std::int32_t poc{};
+};
+
+// Access units of an Annex-B bitstream starting at a random access point, in decoding order. Only the first slice
+// segment header of each picture is read.
+// Throws std::runtime_error on malformed or unsupported data.
+auto splitAccessUnits(common::misc::ByteSpan inputData) -> std::vector<AccessUnit>;
+// Rank of each access unit in output order
+auto getOutputOrder(const std::vector<AccessUnit> &accessUnitList) -> std::vector<std::uint32_t>;
+} // namespace hevc
@@ -11,11 +11,47 @@
 
 #pragma once
 
+#include <common/misc/span.h>
 #include <common/misc/types.h>
+#include <memory>
 
 namespace miv
 {
+struct SessionState;
+
+// Video sub-bitstreams of a segment, one set per atlas in V3C parameter set order
+using AtlasDataPacketList = std::vector<std::array<DataPacket, VideoStream::Size>>;
+
+// Parsing state of one item, kept across its consecutive segments. Parameter set, common atlas and atlas units
+// byte-identical to those of the previous segment are not decoded again, any change is caught by the comparison.
+// A segment identical in all of them gets the metadata of the previous one, shared rather than copied.
+// reset() drops the state on a discontinuity (media switch, seek) so that nothing stale is held meanwhile.
+class Session
+{
+private:
+    std::unique_ptr<SessionState> m_state;
+    unsigned m_nbThread{};
+
+public:
+    Session();
+    ~Session();
+    Session(const Session &) = delete;
+    Session(Session &&) noexcept;
+    auto operator=(const Session &) -> Session & = delete;
+    auto operator=(Session &&) noexcept -> Session &;
+    void reset();
+    // Bound on the threads parsing one segment, its metadata and each video sub-bitstream being separate tasks
+    void setNumberOfThreads(unsigned nbThread) { m_nbThread = nbThread; }
+    // Parses the V3C sample stream in place, each video sub-bitstream is written once into its packet.
+    // The metadata is null when the segment fails to decode.
+    auto decode(common::misc::ByteSpan inputData) -> std::pair<MivMetadataPtr, AtlasDataPacketList>;
+    // Same as decode without the video demux, for buffers reduced by extractMivMetadata
+    auto decodeMetadata(common::misc::ByteSpan inputData) -> MivMetadataPtr;
+};
+
 auto getVideoStreamName(int videoStreamId) -> const std::string &;
-auto decodeMivBuffer(std::string inputData)
-    -> std::pair<TMIV::MivBitstream::AccessUnit, std::array<DataPacket, VideoStream::Size>>;
+// One-off parse of a segment, through a session of its own
+auto decodeMivBuffer(common::misc::ByteSpan inputData) -> std::pair<MivMetadataPtr, AtlasDataPacketList>;
+// Keeps the parameter set and atlas units of a V3C sample stream, dropping the video units
+auto extractMivMetadata(common::misc::ByteSpan inputData) -> std::string;
 } // namespace miv
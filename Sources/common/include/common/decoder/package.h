@@ -0,0 +1,46 @@
+/*
+* Copyright (c) 2025 InterDigital CE Patent Holdings SASU
+* Licensed under the License terms of 5GMAG software (the "License").
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at https://www.5g-mag.com/license .
+* Unless required by applicable law or agreed to in writing, software distributed under the License is
+* distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and limitations under the License.
+*/
+
+#pragma once
+
+#include <common/decoder/miv.h>
+
+// Pre-demuxed MIV / V-PCC segments, written offline by V3CImmersivePackager.
+// A package stores the Annex-B video sub-bitstreams next to the frame metadata, so that playing it does not go
+// through the V3C demux. Packaged segments replace the original ones in the playlist, under the same stream type.
+namespace package
+{
+struct Segment
+{
+    // Chunk::Header::TypeId::Miv or Chunk::Header::TypeId::Vpcc
+    std::uint8_t typeId{};
+    std::uint32_t nbFrame{};
+    double duration{};
+    std::array<DataPacket, VideoStream::Size> videoDataPacketList{};
+    // MIV: V3C sample stream reduced to its parameter set and atlas units (see miv::extractMivMetadata)
+    std::string mivMetadata{};
+    // V-PCC: per-frame patch metadata
+    std::vector<VpccMetadata> vpccMetadata{};
+};
+
+auto isPackage(const std::uint8_t *data, std::size_t size) -> bool;
+auto encode(const Segment &segment) -> std::vector<std::uint8_t>;
+// Throws std::runtime_error on a truncated or unsupported package
+auto decode(const std::uint8_t *data, std::size_t size) -> Segment;
+// Duration and number of frames, read from the package header only
+auto readProperty(const std::uint8_t *data, std::size_t size) -> std::pair<double, std::uint32_t>;
+
+// Drop-in replacements of miv::Session::decode / decodeVpccBuffer for packaged segments (single atlas)
+auto decodeMivPackage(const std::uint8_t *data, std::size_t size, miv::Session &session)
+    -> std::pair<MivMetadataPtr, miv::AtlasDataPacketList>;
+auto decodeVpccPackage(const std::uint8_t *data, std::size_t size)
+    -> std::pair<std::vector<VpccMetadata>, std::array<DataPacket, VideoStream::Size>>;
+} // namespace package
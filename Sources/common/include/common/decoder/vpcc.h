@@ -11,8 +11,32 @@
 
 #pragma once
 
+#include <common/misc/span.h>
 #include <common/misc/types.h>
 
+namespace vpcc
+{
+// Video units of one sub-bitstream, in place in the segment (NAL units prefixed by their 4-byte size)
+using VideoUnitList = std::vector<common::misc::ByteSpan>;
+
+struct Segment
+{
+    // Frames with at least one patch, in decoding order
+    std::vector<VpccMetadata> frameList;
+    std::array<VideoUnitList, VideoStream::Size> videoUnitList;
+};
+
+// Reads the atlas data of a V3C sample stream holding V-PCC content (first atlas, single tile frames), down to the
+// patch parameters only: no reconstruction structure is allocated and video units are not copied. The metadata of
+// the frames is then extracted on up to nbThread threads, frames keeping their decoding order.
+// Throws std::runtime_error on malformed or unsupported atlas data.
+auto parse(common::misc::ByteSpan inputData, unsigned nbThread = 1) -> Segment;
+// Annex-B sub-bitstream of the video units, written once into a buffer sized beforehand. Empty when truncated.
+auto toAnnexB(const VideoUnitList &videoUnitList) -> DataDescriptor::container_type;
+} // namespace vpcc
+
 auto getVpccVideoStreamName(int videoStreamId) -> const std::string &;
-auto decodeVpccBuffer(std::vector<uint8_t> &inputData)
+// Frame metadata and video sub-bitstreams of a V-PCC segment, no frame when it fails to decode. Frame metadata is
+// extracted on up to nbThread threads.
+auto decodeVpccBuffer(common::misc::ByteSpan inputData, unsigned nbThread = 1)
     -> std::pair<std::vector<VpccMetadata>, std::array<DataPacket, VideoStream::Size>>;
@@ -0,0 +1,40 @@
+/*
+* Copyright (c) 2025 InterDigital CE Patent Holdings SASU
+* Licensed under the License terms of 5GMAG software (the "License").
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at https://www.5g-mag.com/license .
+* Unless required by applicable law or agreed to in writing, software distributed under the License is
+* distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and limitations under the License.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace common::misc
+{
+// Non-owning view over contiguous elements (std::span is C++20)
+template<typename T>
+class Span
+{
+private:
+    T *m_data{};
+    std::size_t m_size{};
+
+public:
+    constexpr Span() = default;
+    constexpr Span(T *data, std::size_t size): m_data{data}, m_size{size} {}
+    constexpr auto data() const -> T * { return m_data; }
+    constexpr auto size() const -> std::size_t { return m_size; }
+    constexpr auto empty() const -> bool { return m_size == 0; }
+    constexpr auto begin() const -> T * { return m_data; }
+    constexpr auto end() const -> T * { return m_data + m_size; }
+    constexpr auto operator[](std::size_t i) const -> T & { return m_data[i]; }
+    constexpr auto subspan(std::size_t offset, std::size_t count) const -> Span { return {m_data + offset, count}; }
+};
+
+using ByteSpan = Span<const std::uint8_t>;
+} // namespace common::misc
@@ -11,11 +11,23 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
+#include <cstddef>
+#include <thread>
 #include <vector>
 
 namespace common::misc
 {
+// What pushing to a full queue does
+enum class OverflowPolicy
+{
+    // The element is dropped and counted, push returning false
+    Reject,
+    // The producer yields until the consumer makes room, or until the queue is closed
+    Block
+};
+
 template<typename T>
 class SpScQueue
 {
@@ -26,65 +38,135 @@ class SpScQueue
     // tradeoff to allow the lock-free implementation of the queue.
     // The size argument at construction and at the resize method should be understood as the
     // desired number of useful elements in the queue.
+    // One thread pushes, one thread pops. size() and the counters may be read from any thread.
 
     static constexpr size_t defaultSize{4};
+    // Keeps the indices written by the producer and by the consumer on their own cache lines
+    static constexpr size_t cacheLineSize{64};
 
     std::vector<T> m_buffer;
-    size_t m_size{defaultSize};
-    std::atomic_size_t m_head{0};
-    std::atomic_size_t m_tail{0};
+    size_t m_size{defaultSize + 1};
+    OverflowPolicy m_policy{OverflowPolicy::Reject};
+
+    // Written by the consumer
+    alignas(cacheLineSize) std::atomic_size_t m_head{0};
+    // Written by the producer
+    alignas(cacheLineSize) std::atomic_size_t m_tail{0};
+    std::atomic_size_t m_dropCount{0};
+    std::atomic_size_t m_maxOccupancy{0};
+    std::atomic_bool m_closed{false};
 
 public:
-    SpScQueue(): m_buffer(defaultSize) {}
-    SpScQueue(size_t size): m_buffer(size+1), m_size{size+1} {}
+    SpScQueue(): m_buffer(defaultSize + 1) {}
+    explicit SpScQueue(size_t size, OverflowPolicy policy = OverflowPolicy::Reject)
+        : m_buffer(size + 1), m_size{size + 1}, m_policy{policy}
+    {
+    }
 
-    void resize(size_t size)
+    // Not thread safe, the queue is emptied
+    void resize(size_t size, OverflowPolicy policy = OverflowPolicy::Reject)
     {
-        m_buffer.resize(size+1);
-        m_size = size+1;
+        m_buffer.assign(size + 1, T{});
+        m_size = size + 1;
+        m_policy = policy;
+        clear();
     }
 
-    void push(T &&t)
+    auto push(T &&t) -> bool
     {
-        m_buffer[m_tail] = std::move(t);
-        size_t next = (m_tail + 1) % m_size;
-        m_tail = next;
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+
+        if (!waitForRoom(1))
+        {
+            return false;
+        }
+
+        m_buffer[tail] = std::move(t);
+        m_tail.store((tail + 1) % m_size, std::memory_order_release);
+        updateMaxOccupancy();
+
+        return true;
     }
 
-    void copy_push(T &t)
+    auto copy_push(const T &t) -> bool
     {
-        m_buffer[m_tail] = t;
-        size_t next = (m_tail + 1) % m_size;
-        m_tail = next;
+        T copy = t;
+        return push(std::move(copy));
     }
 
-    T &front() { return m_buffer[m_head]; }
+    // Pushes count copies of t, all of them or none. Under Block, the producer yields until there is room for all of
+    // them. Rejected when the queue is closed, or is full under Reject or smaller than count, each copy being counted
+    // as dropped.
+    auto copy_push(const T &t, size_t count) -> bool
+    {
+        if (!waitForRoom(count))
+        {
+            return false;
+        }
+
+        // Published at once, the consumer never seeing part of them
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            m_buffer[tail] = t;
+            tail = (tail + 1) % m_size;
+        }
+
+        m_tail.store(tail, std::memory_order_release);
+        updateMaxOccupancy();
 
+        return true;
+    }
+
+    T &front() { return m_buffer[m_head.load(std::memory_order_relaxed)]; }
+
+    // The element is released right away, not when its slot is reused
     void pop()
     {
-        size_t next = (m_head + 1) % m_size;
-        m_head = next;
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        m_buffer[head] = T{};
+        m_head.store((head + 1) % m_size, std::memory_order_release);
     }
 
     template<typename Lambda>
     void pop(Lambda &onPop)
     {
-        size_t head = m_head;
-        onPop(m_buffer[head]);
-        size_t next = (head + 1) % m_size;
-        m_head = next;
+        onPop(front());
+        pop();
+    }
+
+    bool empty() const { return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire); }
+
+    bool full() const
+    {
+        return (m_tail.load(std::memory_order_acquire) + 1) % m_size == m_head.load(std::memory_order_acquire);
     }
 
-    bool empty() { return m_head == m_tail; }
+    // Exact from the producer or the consumer, a snapshot from any other thread
+    auto size() const -> size_t
+    {
+        return (m_size + m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire)) % m_size;
+    }
+    auto capacity() const -> size_t { return m_size - 1; }
 
-    bool full() { return (m_tail + 1) % m_size == m_head; } //(m_size + m_head - m_tail - 1) % m_size == 0; }
+    // Elements rejected for lack of room, and highest number of elements queued
+    auto getDropCount() const -> size_t { return m_dropCount.load(std::memory_order_relaxed); }
+    auto getMaxOccupancy() const -> size_t { return m_maxOccupancy.load(std::memory_order_relaxed); }
+
+    // Releases a producer blocked on a full queue, later pushes failing until the queue is cleared
+    void close() { m_closed.store(true, std::memory_order_release); }
 
     // the following need to be specialized for objects holding memory
     // and are not thread safe
     void clear()
     {
+        std::fill(m_buffer.begin(), m_buffer.end(), T{});
         m_head = 0;
         m_tail = 0;
+        m_dropCount = 0;
+        m_maxOccupancy = 0;
+        m_closed = false;
     }
 
     template<typename Lambda>
@@ -93,6 +175,44 @@ public:
         for (T &t : m_buffer)
             action(t);
     }
+
+private:
+    // The consumer only ever makes room, so the room checked by the producer stays available
+    auto waitForRoom(size_t count) -> bool
+    {
+        for (;;)
+        {
+            if (m_closed.load(std::memory_order_acquire))
+            {
+                break;
+            }
+
+            if (count <= capacity() - size())
+            {
+                return true;
+            }
+
+            if ((m_policy == OverflowPolicy::Reject) || (capacity() < count))
+            {
+                break;
+            }
+
+            std::this_thread::yield();
+        }
+
+        m_dropCount.fetch_add(count, std::memory_order_relaxed);
+
+        return false;
+    }
+    void updateMaxOccupancy()
+    {
+        const auto occupancy = size();
+
+        if (m_maxOccupancy.load(std::memory_order_relaxed) < occupancy)
+        {
+            m_maxOccupancy.store(occupancy, std::memory_order_relaxed);
+        }
+    }
 };
 
 } // namespace common::misc
@@ -15,6 +15,8 @@
 #include <iloj/gpu/types.h>
 #include <iloj/media/descriptor.h>
 #include <iloj/misc/packet.h>
+#include <cstddef>
+#include <memory>
 
 using HANDLE = void *;
 
@@ -45,8 +47,20 @@ enum VideoStream
 
 using VideoStreamType = decltype(VideoStream::Occupancy);
 
-struct VpccPatchMetadata
-{  
+// Binary layout of the V-PCC frame metadata, shared with the synthesizer and uploaded as is to the GPU:
+// - blockToPatch: one entry per patch packing block, row after row, 0 where no patch lies, otherwise the index of
+//   the patch plus one. Uploaded as a R16UI texture of frame_width / 16 x frame_height / 16 texels.
+// - patchBlockBuffers: 16 bytes per patch, the 8 fields below in order, uploaded as a RGBA16UI texture, patch p
+//   being texels 2 (p % vpccPatchTableWidth) and 2 (p % vpccPatchTableWidth) + 1 of row p / vpccPatchTableWidth.
+//   The table is padded with empty patches up to a whole number of rows.
+// The version is to be bumped on any change to these structures.
+constexpr std::uint32_t vpccMetadataLayoutVersion = 2;
+// Patches per row of the patch table, 65535 patches fitting in 1024 rows
+constexpr std::size_t vpccPatchTableWidth = 64;
+constexpr std::size_t vpccMaxPatchCount = 65535;
+
+struct alignas(16) VpccPatchMetadata
+{
     uint16_t U0{0};
     uint16_t V0{0};
     uint16_t U1{0};
@@ -57,17 +71,33 @@ struct VpccPatchMetadata
     uint16_t ProjectionMode{0};
 };
 
+static_assert(sizeof(VpccPatchMetadata) == 16, "V-PCC patch table entries are two RGBA16UI texels");
+static_assert(offsetof(VpccPatchMetadata, D1) == 8, "V-PCC patch table entries are two RGBA16UI texels");
+
 struct VpccMetadata
 {
+    // Stays the first member whatever the version
+    std::uint32_t layout_version{vpccMetadataLayoutVersion};
     int frame_index{-1};
     int frame_width;
     int frame_height;
-    
+    // Patches of the frame, patchBlockBuffers holding the padding after them
+    int patch_count{0};
+
     std::vector<VpccPatchMetadata> patchBlockBuffers = {};
-    std::vector<size_t> blockToPatch = {};
+    std::vector<std::uint16_t> blockToPatch = {};
 };
 
+// Number of entries of the patch table holding nbPatch patches, padded to whole rows
+inline auto getVpccPatchTableSize(std::size_t nbPatch) -> std::size_t
+{
+    return (nbPatch + vpccPatchTableWidth - 1) / vpccPatchTableWidth * vpccPatchTableWidth;
+}
+
 using MivMetadata = TMIV::MivBitstream::AccessUnit;
+// Parsed MIV metadata, immutable once built. The MIV session shares it with the following segments for as long as
+// their parameter set and atlas units do not change.
+using MivMetadataPtr = std::shared_ptr<const MivMetadata>;
 
 struct GenericMetadata
 {
@@ -87,11 +117,11 @@ struct GenericMetadata
     GenericMetadata(VpccMetadata vpcc)
     {
         MIVMetadata = std::make_unique<MivMetadata>();
-        VPCCMetadata = std::make_unique<VpccMetadata>(vpcc);
+        VPCCMetadata = std::make_unique<VpccMetadata>(std::move(vpcc));
         contentType = VPCC;
     }
 
-    GenericMetadata(MivMetadata miv)
+    GenericMetadata(const MivMetadata &miv)
     {
         MIVMetadata = std::make_unique<MivMetadata>(miv);
         VPCCMetadata = std::make_unique<VpccMetadata>();
@@ -100,6 +130,8 @@ struct GenericMetadata
 
     
 
+    // Read as is by the synthesizers through GenericMetadata pointers. MIVMetadata->foc is moved along by the renderer
+    // from one frame of the segment to the next.
     std::unique_ptr<MivMetadata> MIVMetadata;
     std::unique_ptr<VpccMetadata> VPCCMetadata;
 
@@ -115,6 +147,8 @@ struct DecodedVideoData
 {
     GenericMetadataPacket metadataPacket;
     std::array<VideoPacket, VideoStream::Size> videoPacketList;
+    // MIV: frames of the atlases after the first one, decoded for the same instant
+    std::vector<std::array<VideoPacket, VideoStream::Size>> atlasVideoPacketList;
 };
 
 using DecodedVideoPacket = iloj::misc::Packet<DecodedVideoData>;
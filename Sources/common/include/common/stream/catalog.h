@@ -0,0 +1,52 @@
+/*
+* Copyright (c) 2025 InterDigital CE Patent Holdings SASU
+* Licensed under the License terms of 5GMAG software (the "License").
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at https://www.5g-mag.com/license .
+* Unless required by applicable law or agreed to in writing, software distributed under the License is
+* distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and limitations under the License.
+*/
+
+#pragma once
+
+#include "item.h"
+#include <memory>
+#include <mutex>
+
+// Playlist of the session, parsed once from the library and shared read-only by all the components.
+// Names and modes are known upfront, items (and their segment index) are only built when first requested.
+class Catalog
+{
+private:
+    // Built once, concurrently with the other items: an item only reads (and completes) its own playlist entry
+    struct ItemSlot
+    {
+        std::once_flag flag;
+        std::unique_ptr<const Item> item;
+    };
+
+    mutable iloj::misc::JSON::Object m_library;
+    std::vector<std::unique_ptr<ItemSlot>> m_itemList;
+    std::vector<std::string> m_nameList;
+    std::vector<std::string> m_modeList;
+
+    Catalog() = default;
+
+public:
+    Catalog(const Catalog &) = delete;
+    Catalog(Catalog &&) = delete;
+    auto operator=(const Catalog &) -> Catalog & = delete;
+    auto operator=(Catalog &&) -> Catalog & = delete;
+    auto getNumberOfItems() const -> std::size_t { return m_nameList.size(); }
+    auto getNameList() const -> const std::vector<std::string> & { return m_nameList; }
+    auto getName(std::size_t itemId) const -> const std::string & { return m_nameList[itemId]; }
+    auto getMode(std::size_t itemId) const -> const std::string & { return m_modeList[itemId]; }
+    // Thread-safe, the item is built with its segment index on first request, callers asking for the same item
+    // waiting for it and the others not
+    auto getItem(std::size_t itemId) const -> const Item &;
+
+    // Returns nullptr if the library referenced by the configuration file is missing or empty
+    static auto fromConfig(const std::string &configFile) -> std::shared_ptr<const Catalog>;
+};
@@ -12,6 +12,7 @@
 #pragma once
 
 #include <chrono>
+#include <memory>
 #include <vector>
 
 class Chunk
@@ -75,10 +76,15 @@ public:
     };
 
     using Buffer = std::vector<std::uint8_t>;
+    // Shared owner of payload bytes living outside the chunk (e.g. a memory-mapped segment)
+    using Storage = std::shared_ptr<const void>;
 
 private:
     Header m_header{};
     Buffer m_data{};
+    Storage m_storage{};
+    const std::uint8_t *m_view{};
+    std::size_t m_viewSize{};
 
 public:
     Chunk() = default;
@@ -86,6 +92,11 @@ public:
     {
         m_header.setDataSize(m_data.size());
     }
+    Chunk(const Header &header, Storage storage, const std::uint8_t *data, std::size_t size)
+        : m_header{header}, m_storage{std::move(storage)}, m_view{data}, m_viewSize{size}
+    {
+        m_header.setDataSize(m_viewSize);
+    }
     Chunk(const Chunk &) = default;
     Chunk(Chunk &&) = default;
     auto operator=(const Chunk &) -> Chunk & = default;
@@ -95,8 +106,30 @@ public:
     void setData(Buffer&& data)
     {
         m_data = std::move(data);
+        m_storage.reset();
+        m_view = nullptr;
+        m_viewSize = 0;
         m_header.setDataSize(m_data.size());
     }
+    // Owned buffer only, empty when the payload is shared (see data() / size())
     auto getData() const -> const Buffer & { return m_data; }
     auto getData() -> Buffer & { return m_data; }
+    auto isShared() const -> bool { return static_cast<bool>(m_storage); }
+    auto data() const -> const std::uint8_t * { return m_storage ? m_view : m_data.data(); }
+    auto size() const -> std::size_t { return m_storage ? m_viewSize : m_data.size(); }
+    auto empty() const -> bool { return size() == 0; }
+    // Hands the payload over as an owned buffer. A shared payload is copied here, once, and released.
+    auto releaseData() -> Buffer
+    {
+        if (m_storage)
+        {
+            Buffer data(m_view, m_view + m_viewSize);
+            m_storage.reset();
+            m_view = nullptr;
+            m_viewSize = 0;
+            return data;
+        }
+
+        return std::move(m_data);
+    }
 };
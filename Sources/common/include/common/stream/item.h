@@ -12,6 +12,8 @@
 #pragma once
 
 #include "chunk.h"
+#include "segment_cache.h"
+#include "segment_io.h"
 #include <iloj/misc/json.h>
 
 class Item
@@ -90,6 +92,7 @@ public:
     };
 
     using Property = std::vector<std::pair<double, std::uint32_t>>;
+    using Segment = std::tuple<std::size_t, Chunk, std::chrono::duration<double>>;
 
 private:
     int m_itemId{-1};
@@ -98,6 +101,9 @@ private:
     std::vector<State> m_streamState{};
     std::vector<Property> m_streamProperty{};
     std::string m_mode;
+    bool m_memoryMapping{false};
+    std::shared_ptr<SegmentCache> m_segmentCache;
+    std::shared_ptr<SegmentIO> m_segmentIO;
 
 public:
     Item() = default;
@@ -109,10 +115,23 @@ public:
     auto getItemId() const -> int { return m_itemId; }
     auto getName() const -> const std::string & { return m_name; }
     auto getMode() const -> const std::string & { return m_mode; }
+    void setMemoryMapping(bool enabled) { m_memoryMapping = enabled; }
+    void setSegmentCache(std::shared_ptr<SegmentCache> segmentCache) { m_segmentCache = std::move(segmentCache); }
+    void setSegmentIO(std::shared_ptr<SegmentIO> segmentIO) { m_segmentIO = std::move(segmentIO); }
     void reset();
-    auto next() -> std::tuple<std::size_t, Chunk, std::chrono::duration<double>>;
+    // Moves every stream to the segment covering position (in seconds), returns the earliest segment start
+    auto seek(double position) -> double;
+    auto getStreamDelay(std::size_t streamId) const -> double { return m_streamState[streamId].getStreamDelay(); }
+    auto next() -> Segment;
+    // True once next() would loop back to the first segments, the last one of the most late stream being sent
+    auto isAtEnd() const -> bool;
+    // Same as calling next() nbSegment times, the uncached segments being read in a single batch
+    auto next(std::size_t nbSegment) -> std::vector<Segment>;
     auto getNumberOfStreams() const -> std::size_t { return m_streamList.size(); }
 
-    static std::vector<Item> makeItemList(iloj::misc::JSON::Object &config, unsigned int nbChannel, bool buildIndex = false);
     inline const std::vector<Stream> &getStreams() const { return m_streamList; }
+
+    // Playlist entry attributes, readable without building the item
+    static auto readName(const iloj::misc::JSON::Object &jsonItem, int itemId) -> std::string;
+    static auto readMode(const iloj::misc::JSON::Object &jsonItem) -> std::string;
 };
\ No newline at end of file
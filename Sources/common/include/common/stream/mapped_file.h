@@ -0,0 +1,44 @@
+/*
+* Copyright (c) 2025 InterDigital CE Patent Holdings SASU
+* Licensed under the License terms of 5GMAG software (the "License").
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at https://www.5g-mag.com/license .
+* Unless required by applicable law or agreed to in writing, software distributed under the License is
+* distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and limitations under the License.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Read-only mapping of a whole file, backed by the page cache. The mapping is released when the
+// last shared reference is dropped, so chunks can point into it without copying the segment.
+// The file must not shrink while mapped: reading past its new end raises SIGBUS.
+class MappedFile
+{
+private:
+    const std::uint8_t *m_data{};
+    std::size_t m_size{};
+#ifdef _WIN32
+    void *m_fileHandle{};
+    void *m_mappingHandle{};
+#endif
+
+    MappedFile() = default;
+
+public:
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile(MappedFile &&) = delete;
+    auto operator=(const MappedFile &) -> MappedFile & = delete;
+    auto operator=(MappedFile &&) -> MappedFile & = delete;
+    auto data() const -> const std::uint8_t * { return m_data; }
+    auto size() const -> std::size_t { return m_size; }
+
+    // Returns nullptr if the file cannot be mapped (missing, empty or unsupported filesystem)
+    static auto open(const std::string &path) -> std::shared_ptr<const MappedFile>;
+};
@@ -0,0 +1,71 @@
+/*
+* Copyright (c) 2025 InterDigital CE Patent Holdings SASU
+* Licensed under the License terms of 5GMAG software (the "License").
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at https://www.5g-mag.com/license .
+* Unless required by applicable law or agreed to in writing, software distributed under the License is
+* distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and limitations under the License.
+*/
+
+#pragma once
+
+#include "chunk.h"
+#include "segment_index.h"
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+// Least recently used segment payloads, bounded in bytes and keyed by segment path. Each payload is stamped with the
+// size and modification time of its file, a segment replaced on disk missing the cache.
+// Payloads are shared with the chunks served from the cache, an evicted payload lives on until its last chunk is gone.
+class SegmentCache
+{
+public:
+    struct Entry
+    {
+        Chunk::Storage storage{};
+        const std::uint8_t *data{};
+        std::size_t size{};
+    };
+
+private:
+    struct Node
+    {
+        std::string path;
+        SegmentIndex::Stamp stamp;
+        Entry entry;
+    };
+
+    using List = std::list<Node>;
+
+    std::size_t m_capacity{};
+    std::size_t m_bytes{};
+    // Most recently used first
+    List m_list;
+    std::unordered_map<std::string, List::iterator> m_entryMap;
+    std::mutex m_mutex;
+    std::atomic<std::uint64_t> m_hits{};
+    std::atomic<std::uint64_t> m_misses{};
+
+public:
+    explicit SegmentCache(std::size_t capacity): m_capacity{capacity} {}
+    SegmentCache(const SegmentCache &) = delete;
+    SegmentCache(SegmentCache &&) = delete;
+    auto operator=(const SegmentCache &) -> SegmentCache & = delete;
+    auto operator=(SegmentCache &&) -> SegmentCache & = delete;
+    auto getCapacity() const -> std::size_t { return m_capacity; }
+    auto getHits() const -> std::uint64_t { return m_hits; }
+    auto getMisses() const -> std::uint64_t { return m_misses; }
+    auto getBytes() -> std::size_t;
+    // Counts a hit or a miss, an entry with another stamp being dropped
+    auto find(const std::string &path, const SegmentIndex::Stamp &stamp) -> std::optional<Entry>;
+    // Evicts the least recently used entries to make room, payloads larger than the capacity or of a missing file
+    // (empty stamp) are not cached
+    void insert(const std::string &path, const SegmentIndex::Stamp &stamp, Entry entry);
+    void clear();
+};
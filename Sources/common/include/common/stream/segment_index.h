@@ -0,0 +1,58 @@
+/*
+* Copyright (c) 2025 InterDigital CE Patent Holdings SASU
+* Licensed under the License terms of 5GMAG software (the "License").
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at https://www.5g-mag.com/license .
+* Unless required by applicable law or agreed to in writing, software distributed under the License is
+* distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and limitations under the License.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+// Binary sidecar caching the duration / number of frames of every segment of an item.
+// Entries are keyed by segment path and validated against the file size and modification time,
+// so only segments that changed since the index was written have to be probed again.
+class SegmentIndex
+{
+public:
+    struct Stamp
+    {
+        std::uint64_t fileSize{};
+        std::int64_t modificationTime{};
+
+        auto operator==(const Stamp &other) const -> bool
+        {
+            return fileSize == other.fileSize && modificationTime == other.modificationTime;
+        }
+    };
+
+    struct Entry
+    {
+        Stamp stamp{};
+        double duration{};
+        std::uint32_t nbFrame{};
+    };
+
+private:
+    std::string m_path;
+    std::unordered_map<std::string, Entry> m_entryMap;
+    bool m_modified{false};
+
+public:
+    explicit SegmentIndex(std::string path);
+    auto getPath() const -> const std::string & { return m_path; }
+    // Returns the cached entry if it is still valid for the given stamp
+    auto find(const std::string &segmentPath, const Stamp &stamp) const -> const Entry *;
+    void update(const std::string &segmentPath, const Entry &entry);
+    // Writes the index back if it was modified
+    auto save() -> bool;
+
+    // Returns an empty stamp if the segment does not exist
+    static auto getStamp(const std::string &segmentPath) -> Stamp;
+};
@@ -0,0 +1,51 @@
+/*
+* Copyright (c) 2025 InterDigital CE Patent Holdings SASU
+* Licensed under the License terms of 5GMAG software (the "License").
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at https://www.5g-mag.com/license .
+* Unless required by applicable law or agreed to in writing, software distributed under the License is
+* distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and limitations under the License.
+*/
+
+#pragma once
+
+#include "chunk.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// Backend reading whole segment files, several at once when the platform allows it
+class SegmentIO
+{
+public:
+    struct Request
+    {
+        std::string path;
+        Chunk::Buffer data{};
+        bool valid{false};
+    };
+
+public:
+    SegmentIO() = default;
+    virtual ~SegmentIO() = default;
+    SegmentIO(const SegmentIO &) = delete;
+    SegmentIO(SegmentIO &&) = delete;
+    auto operator=(const SegmentIO &) -> SegmentIO & = delete;
+    auto operator=(SegmentIO &&) -> SegmentIO & = delete;
+    virtual auto getName() const -> std::string = 0;
+    // Thread-safe, fills data and valid for every request
+    virtual void read(std::vector<Request> &requestList) = 0;
+
+    // "io_uring" needs a build with USE_IO_URING and a kernel supporting it, otherwise reads are synchronous
+    static auto create(const std::string &name) -> std::shared_ptr<SegmentIO>;
+};
+
+// Blocking whole-file reads, one after the other
+class SyncSegmentIO: public SegmentIO
+{
+public:
+    auto getName() const -> std::string override { return "sync"; }
+    void read(std::vector<Request> &requestList) override;
+};
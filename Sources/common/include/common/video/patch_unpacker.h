@@ -0,0 +1,71 @@
+/*
+* Copyright (c) 2025 InterDigital CE Patent Holdings SASU
+* Licensed under the License terms of 5GMAG software (the "License").
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at https://www.5g-mag.com/license .
+* Unless required by applicable law or agreed to in writing, software distributed under the License is
+* distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and limitations under the License.
+*/
+
+#pragma once
+
+#include <common/misc/types.h>
+
+// CPU reconstruction of the MIV source views from decoded atlases, without any graphics context
+namespace miv
+{
+// Plane of a decoded atlas frame, 8 to 16-bit samples widened to 16 bits. Null data means the plane is absent.
+struct ImagePlane
+{
+    const std::uint16_t *data{};
+    std::size_t width{};
+    std::size_t height{};
+    // In samples
+    std::size_t stride{};
+
+    auto operator()(std::size_t y, std::size_t x) const -> std::uint16_t { return data[y * stride + x]; }
+};
+
+// Decoded video frames of one atlas. Planes may be smaller than the atlas frame (scaled geometry or occupancy,
+// subsampled chroma), they are then sampled at the nearest position.
+struct AtlasFrame
+{
+    // Non-zero samples are occupied, when absent every pixel of a patch is
+    ImagePlane occupancy;
+    ImagePlane geometry;
+    // Y, Cb, Cr
+    std::array<ImagePlane, 3> texture;
+};
+
+// One source view, all planes being width x height, row after row:
+// - geometry: coded geometry samples, to be dequantized with the depth quantization of the view
+// - texture: Y, Cb and Cr planes one after the other (4:4:4)
+// - occupancy: 0 where no patch landed, otherwise 1 + the index of the atlas the pixel comes from
+// - patchIdx: index of the patch in that atlas, tmiv unusedPatchIdx where no patch landed
+// Patch depth and attribute offsets are not applied, patchIdx gives access to them.
+struct ViewFrame
+{
+    std::size_t width{};
+    std::size_t height{};
+    std::vector<std::uint16_t> geometry;
+    std::vector<std::uint16_t> texture;
+    std::vector<std::uint8_t> occupancy;
+    std::vector<std::uint16_t> patchIdx;
+};
+
+// Unpacks the patches of every atlas into their view through the block-to-patch map, undoing the patch orientation.
+// Views are unpacked concurrently, each by one thread, and within an atlas later patches overwrite earlier ones.
+class PatchUnpacker
+{
+private:
+    unsigned m_nbThread{};
+
+public:
+    PatchUnpacker();
+    void setNumberOfThreads(unsigned nbThread) { m_nbThread = nbThread; }
+    // atlasFrameList[k] holds the frames of atlas k of the access unit
+    auto unpack(const MivMetadata &au, const std::vector<AtlasFrame> &atlasFrameList) const -> std::vector<ViewFrame>;
+};
+} // namespace miv
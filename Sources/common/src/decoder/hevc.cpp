@@ -0,0 +1,485 @@
+/*
+* Copyright (c) 2025 InterDigital CE Patent Holdings SASU
+* Licensed under the License terms of 5GMAG software (the "License").
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at https://www.5g-mag.com/license .
+* Unless required by applicable law or agreed to in writing, software distributed under the License is
+* distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and limitations under the License.
+*/
+
+#include <algorithm>
+#include <array>
+#include <common/decoder/hevc.h>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+
+using common::misc::ByteSpan;
+
+namespace hevc
+{
+namespace
+{
+// nal_unit_type
+enum NalUnitType : std::uint32_t
+{
+    TRAIL_N = 0,
+    RADL_N = 6,
+    RASL_R = 9,
+    RSV_VCL_N14 = 14,
+    BLA_W_LP = 16,
+    IDR_W_RADL = 19,
+    IDR_N_LP = 20,
+    CRA_NUT = 21,
+    RSV_IRAP_VCL23 = 23,
+    RSV_VCL31 = 31,
+    VPS_NUT = 32,
+    SPS_NUT = 33,
+    PPS_NUT = 34,
+    AUD_NUT = 35,
+    PREFIX_SEI_NUT = 39,
+    RSV_NVCL41 = 41,
+    RSV_NVCL44 = 44,
+    UNSPEC48 = 48,
+    UNSPEC55 = 55
+};
+
+// Slice header prefix and parameter sets are read from their RBSP, only the first bytes being needed
+constexpr std::size_t maxHeaderSize = 256;
+
+class BitReader
+{
+private:
+    std::vector<std::uint8_t> m_rbsp;
+    std::size_t m_bitPos{};
+
+public:
+    // Skips the 2-byte NAL unit header
+    explicit BitReader(ByteSpan nalUnit)
+    {
+        unsigned nbZero = 0;
+
+        for (std::size_t i = 2; (i < nalUnit.size()) && (m_rbsp.size() < maxHeaderSize); i++)
+        {
+            auto byte = nalUnit[i];
+
+            if ((2 <= nbZero) && (byte == 3))
+            {
+                nbZero = 0;
+                continue;
+            }
+
+            nbZero = (byte == 0) ? nbZero + 1 : 0;
+            m_rbsp.push_back(byte);
+        }
+    }
+    auto read(unsigned nbBit) -> std::uint32_t
+    {
+        if ((32 < nbBit) || (m_rbsp.size() * 8 - m_bitPos < nbBit))
+        {
+            throw std::runtime_error("Truncated HEVC header");
+        }
+
+        std::uint32_t value = 0;
+
+        for (unsigned i = 0; i < nbBit; i++, m_bitPos++)
+        {
+            value = (value << 1U) | ((m_rbsp[m_bitPos / 8] >> (7U - m_bitPos % 8)) & 1U);
+        }
+
+        return value;
+    }
+    auto readFlag() -> bool { return read(1) != 0; }
+    auto readUe() -> std::uint32_t
+    {
+        unsigned nbZero = 0;
+
+        while (!readFlag())
+        {
+            if (31 < ++nbZero)
+            {
+                throw std::runtime_error("Invalid exp-Golomb code in HEVC header");
+            }
+        }
+
+        return ((std::uint32_t{1} << nbZero) - 1) + read(nbZero);
+    }
+    void skip(unsigned nbBit)
+    {
+        for (; 32 < nbBit; nbBit -= 32)
+        {
+            read(32);
+        }
+
+        read(nbBit);
+    }
+};
+
+struct Sps
+{
+    bool separateColourPlane{};
+    unsigned log2MaxPocLsb{};
+};
+
+struct Pps
+{
+    std::uint32_t spsId{};
+    bool outputFlagPresent{};
+    unsigned numExtraSliceHeaderBits{};
+};
+
+// NAL unit in place, after its start code
+struct NalUnit
+{
+    // Start of its start code, leading zero byte included
+    std::size_t begin{};
+    ByteSpan data;
+
+    auto getType() const -> std::uint32_t { return (data[0] >> 1U) & 0x3FU; }
+    auto getTemporalId() const -> std::uint32_t { return (data[1] & 0x07U) - 1; }
+};
+
+auto splitNalUnits(ByteSpan inputData) -> std::vector<NalUnit>
+{
+    std::vector<NalUnit> nalUnitList;
+    const auto size = inputData.size();
+
+    auto findStartCode = [&](std::size_t from)
+    {
+        for (auto i = from; i + 2 < size; i++)
+        {
+            if ((inputData[i] == 0) && (inputData[i + 1] == 0) && (inputData[i + 2] == 1))
+            {
+                return i;
+            }
+        }
+
+        return size;
+    };
+
+    for (auto pos = findStartCode(0); pos < size;)
+    {
+        auto begin = ((0 < pos) && (inputData[pos - 1] == 0)) ? pos - 1 : pos;
+        auto next = findStartCode(pos + 3);
+        // Trailing zero bytes belong to the next start code
+        auto end = next;
+
+        while ((pos + 3 < end) && (inputData[end - 1] == 0))
+        {
+            end--;
+        }
+
+        if (end - (pos + 3) < 2)
+        {
+            throw std::runtime_error("Truncated HEVC NAL unit");
+        }
+
+        nalUnitList.push_back({begin, inputData.subspan(pos + 3, end - (pos + 3))});
+        pos = next;
+    }
+
+    return nalUnitList;
+}
+
+auto parseSps(ByteSpan nalUnit) -> std::pair<std::uint32_t, Sps>
+{
+    BitReader reader{nalUnit};
+    Sps sps;
+
+    // sps_video_parameter_set_id
+    reader.read(4);
+    const auto maxSubLayersMinus1 = reader.read(3);
+    // sps_temporal_id_nesting_flag
+    reader.read(1);
+
+    // profile_tier_level(1, sps_max_sub_layers_minus1): general profile and level
+    reader.skip(96);
+
+    std::array<bool, 8> subLayerProfilePresent{};
+    std::array<bool, 8> subLayerLevelPresent{};
+
+    for (unsigned i = 0; i < maxSubLayersMinus1; i++)
+    {
+        subLayerProfilePresent[i] = reader.readFlag();
+        subLayerLevelPresent[i] = reader.readFlag();
+    }
+
+    if (0 < maxSubLayersMinus1)
+    {
+        reader.skip(2 * (8 - maxSubLayersMinus1));
+    }
+
+    for (unsigned i = 0; i < maxSubLayersMinus1; i++)
+    {
+        reader.skip((subLayerProfilePresent[i] ? 88 : 0) + (subLayerLevelPresent[i] ? 8 : 0));
+    }
+
+    const auto spsId = reader.readUe();
+
+    if (reader.readUe() == 3)
+    {
+        sps.separateColourPlane = reader.readFlag();
+    }
+
+    // pic_width_in_luma_samples, pic_height_in_luma_samples
+    reader.readUe();
+    reader.readUe();
+
+    if (reader.readFlag())
+    {
+        // conf_win_left_offset, conf_win_right_offset, conf_win_top_offset, conf_win_bottom_offset
+        for (int i = 0; i < 4; i++)
+        {
+            reader.readUe();
+        }
+    }
+
+    // bit_depth_luma_minus8, bit_depth_chroma_minus8
+    reader.readUe();
+    reader.readUe();
+
+    sps.log2MaxPocLsb = reader.readUe() + 4;
+
+    if (16 < sps.log2MaxPocLsb)
+    {
+        throw std::runtime_error("Invalid HEVC picture order count size");
+    }
+
+    return {spsId, sps};
+}
+
+auto parsePps(ByteSpan nalUnit) -> std::pair<std::uint32_t, Pps>
+{
+    BitReader reader{nalUnit};
+    Pps pps;
+
+    const auto ppsId = reader.readUe();
+
+    pps.spsId = reader.readUe();
+    // dependent_slice_segments_enabled_flag
+    reader.read(1);
+    pps.outputFlagPresent = reader.readFlag();
+    pps.numExtraSliceHeaderBits = reader.read(3);
+
+    return {ppsId, pps};
+}
+
+auto isVcl(std::uint32_t type) -> bool { return type <= RSV_VCL31; }
+auto isIrap(std::uint32_t type) -> bool { return (BLA_W_LP <= type) && (type <= RSV_IRAP_VCL23); }
+
+// NAL units starting an access unit when following the last VCL NAL unit of a picture
+auto isAccessUnitPrefix(std::uint32_t type) -> bool
+{
+    return ((VPS_NUT <= type) && (type <= AUD_NUT)) || (type == PREFIX_SEI_NUT) ||
+           ((RSV_NVCL41 <= type) && (type <= RSV_NVCL44)) || ((UNSPEC48 <= type) && (type <= UNSPEC55));
+}
+} // namespace
+
+auto splitAccessUnits(ByteSpan inputData) -> std::vector<AccessUnit>
+{
+    std::vector<AccessUnit> accessUnitList;
+    std::vector<std::optional<Sps>> spsList(16);
+    std::vector<std::optional<Pps>> ppsList(64);
+
+    const auto nalUnitList = splitNalUnits(inputData);
+
+    std::optional<std::size_t> auBegin;
+    bool hasVcl = false;
+    std::int32_t prevTid0Poc = 0;
+
+    auto closeAccessUnit = [&](std::size_t end)
+    {
+        if (auBegin && hasVcl)
+        {
+            accessUnitList.back().data = inputData.subspan(*auBegin, end - *auBegin);
+        }
+
+        auBegin.reset();
+        hasVcl = false;
+    };
+
+    for (const auto &nalUnit : nalUnitList)
+    {
+        const auto type = nalUnit.getType();
+
+        if (isVcl(type))
+        {
+            // first_slice_segment_in_pic_flag
+            if ((nalUnit.data.size() < 3) || ((nalUnit.data[2] & 0x80U) == 0))
+            {
+                continue;
+            }
+
+            if (hasVcl)
+            {
+                closeAccessUnit(nalUnit.begin);
+            }
+
+            if (accessUnitList.empty() && !isIrap(type))
+            {
+                throw std::runtime_error("HEVC bitstream not starting at a random access point");
+            }
+
+            BitReader reader{nalUnit.data};
+
+            reader.read(1);
+
+            if (isIrap(type))
+            {
+                // no_output_of_prior_pics_flag
+                reader.read(1);
+            }
+
+            const auto ppsId = reader.readUe();
+
+            if ((ppsList.size() <= ppsId) || !ppsList[ppsId] || (spsList.size() <= ppsList[ppsId]->spsId) ||
+                !spsList[ppsList[ppsId]->spsId])
+            {
+                throw std::runtime_error("HEVC slice referring to a missing parameter set");
+            }
+
+            const auto &pps = *ppsList[ppsId];
+            const auto &sps = *spsList[pps.spsId];
+
+            reader.skip(pps.numExtraSliceHeaderBits);
+            // slice_type
+            reader.readUe();
+
+            if (pps.outputFlagPresent)
+            {
+                // pic_output_flag
+                reader.read(1);
+            }
+
+            if (sps.separateColourPlane)
+            {
+                // colour_plane_id
+                reader.read(2);
+            }
+
+            AccessUnit au;
+
+            // IRAP pictures other than CRA start a coded video sequence, so does the first one
+            const auto newCvs = accessUnitList.empty() || (isIrap(type) && (type < CRA_NUT));
+
+            if (!accessUnitList.empty())
+            {
+                au.cvsIdx = accessUnitList.back().cvsIdx + (newCvs ? 1 : 0);
+            }
+
+            if ((type == IDR_W_RADL) || (type == IDR_N_LP))
+            {
+                au.poc = 0;
+            }
+            else
+            {
+                const auto maxPocLsb = std::int32_t{1} << sps.log2MaxPocLsb;
+                const auto pocLsb = static_cast<std::int32_t>(reader.read(sps.log2MaxPocLsb));
+                std::int32_t pocMsb = 0;
+
+                if (!newCvs)
+                {
+                    const auto prevPocLsb = prevTid0Poc & (maxPocLsb - 1);
+                    const auto prevPocMsb = prevTid0Poc - prevPocLsb;
+
+                    if ((pocLsb < prevPocLsb) && (maxPocLsb / 2 <= prevPocLsb - pocLsb))
+                    {
+                        pocMsb = prevPocMsb + maxPocLsb;
+                    }
+                    else if ((prevPocLsb < pocLsb) && (maxPocLsb / 2 < pocLsb - prevPocLsb))
+                    {
+                        pocMsb = prevPocMsb - maxPocLsb;
+                    }
+                    else
+                    {
+                        pocMsb = prevPocMsb;
+                    }
+                }
+
+                au.poc = pocMsb + pocLsb;
+            }
+
+            // Reference for the next pictures: TemporalId 0, neither RADL, RASL nor sub-layer non-reference
+            const auto isSubLayerNonReference = (type <= RSV_VCL_N14) && (type % 2 == 0);
+
+            if ((nalUnit.getTemporalId() == 0) && !((RADL_N <= type) && (type <= RASL_R)) && !isSubLayerNonReference)
+            {
+                prevTid0Poc = au.poc;
+            }
+
+            if (!auBegin)
+            {
+                auBegin = nalUnit.begin;
+            }
+
+            accessUnitList.push_back(au);
+            hasVcl = true;
+
+            continue;
+        }
+
+        if (hasVcl && isAccessUnitPrefix(type))
+        {
+            closeAccessUnit(nalUnit.begin);
+        }
+
+        if (!auBegin && isAccessUnitPrefix(type))
+        {
+            auBegin = nalUnit.begin;
+        }
+
+        if (type == SPS_NUT)
+        {
+            auto [spsId, sps] = parseSps(nalUnit.data);
+
+            if (spsList.size() <= spsId)
+            {
+                throw std::runtime_error("Invalid HEVC sequence parameter set id");
+            }
+
+            spsList[spsId] = sps;
+        }
+        else if (type == PPS_NUT)
+        {
+            auto [ppsId, pps] = parsePps(nalUnit.data);
+
+            if (ppsList.size() <= ppsId)
+            {
+                throw std::runtime_error("Invalid HEVC picture parameter set id");
+            }
+
+            ppsList[ppsId] = pps;
+        }
+    }
+
+    closeAccessUnit(inputData.size());
+
+    return accessUnitList;
+}
+
+auto getOutputOrder(const std::vector<AccessUnit> &accessUnitList) -> std::vector<std::uint32_t>
+{
+    std::vector<std::uint32_t> decodingOrder(accessUnitList.size());
+    std::iota(decodingOrder.begin(), decodingOrder.end(), 0U);
+
+    std::stable_sort(decodingOrder.begin(),
+                     decodingOrder.end(),
+                     [&](auto i, auto j)
+                     {
+                         const auto &a = accessUnitList[i];
+                         const auto &b = accessUnitList[j];
+                         return (a.cvsIdx < b.cvsIdx) || ((a.cvsIdx == b.cvsIdx) && (a.poc < b.poc));
+                     });
+
+    std::vector<std::uint32_t> rankList(accessUnitList.size());
+
+    for (std::uint32_t rank = 0; rank < decodingOrder.size(); rank++)
+    {
+        rankList[decodingOrder[rank]] = rank;
+    }
+
+    return rankList;
+}
+} // namespace hevc
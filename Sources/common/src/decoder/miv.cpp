@@ -9,20 +9,25 @@
 * See the License for the specific language governing permissions and limitations under the License.
 */
 
-#include <TMIV/Common/Bytestream.h>
 #include <TMIV/Common/verify.h>
 #include <TMIV/Decoder/DecodeAtlas.h>
 #include <TMIV/Decoder/DecodeAtlasSubBitstream.h>
 #include <TMIV/Decoder/DecodeCommonAtlas.h>
 #include <TMIV/Decoder/DecodeNalUnitStream.h>
 #include <TMIV/Decoder/DecodeV3cSampleStream.h>
-#include <TMIV/Decoder/DecodeVideoSubBitstream.h>
 #include <TMIV/Decoder/V3cUnitBuffer.h>
 #include <common/decoder/miv.h>
+#include <algorithm>
+#include <cstring>
+#include <functional>
 #include <iloj/misc/logger.h>
+#include <iloj/misc/thread.h>
+#include <mutex>
+#include <sstream>
 
 using namespace iloj::misc;
 using namespace iloj::media;
+using common::misc::ByteSpan;
 
 namespace miv
 {
@@ -45,31 +50,77 @@ namespace
 {
 void setLoggingStrategy()
 {
-    tmiv::replaceLoggingStrategy(
-        [](tmiv::LogLevel level, std::string_view message)
+    // Segments may be parsed from several threads (e.g. while indexing), install the strategy once
+    static std::once_flag once;
+
+    std::call_once(once,
+                   []()
+                   {
+                       tmiv::replaceLoggingStrategy(
+                           [](tmiv::LogLevel level, std::string_view message)
+                           {
+                               using tmiv::LogLevel;
+                               switch (level)
+                               {
+                                   case LogLevel::error:
+                                       LOG_ERROR(message);
+                                       break;
+                                   case LogLevel::warning:
+                                       LOG_WARNING(message);
+                                       break;
+                                   case LogLevel::info:
+                                       [[fallthrough]]; // TMIV is quite verbose, so log info as debug level
+                                   case LogLevel::verbose:
+                                       [[fallthrough]];
+                                   case LogLevel::debug:
+                                       LOG_DEBUG(message);
+                                       break;
+                                   case LogLevel::silent:
+                                       break;
+                                   default:
+                                       break;
+                               }
+                           });
+                   });
+}
+
+// Runs task(0) ... task(nbTask - 1) on up to nbThread threads, the first exception in task order is rethrown
+void runTasks(std::size_t nbTask, const std::function<void(std::size_t)> &task, unsigned nbThread)
+{
+    if ((nbThread <= 1) || (nbTask <= 1))
+    {
+        for (std::size_t taskId = 0; taskId < nbTask; taskId++)
+        {
+            task(taskId);
+        }
+
+        return;
+    }
+
+    std::vector<std::exception_ptr> errorList(nbTask);
+
+    parallel_for(
+        nbTask,
+        [&](std::size_t taskId)
         {
-            using tmiv::LogLevel;
-            switch (level)
+            try
+            {
+                task(taskId);
+            }
+            catch (...)
             {
-                case LogLevel::error:
-                    LOG_ERROR(message);
-                    break;
-                case LogLevel::warning:
-                    LOG_WARNING(message);
-                    break;
-                case LogLevel::info:
-                    [[fallthrough]]; // TMIV is quite verbose, so log info as debug level
-                case LogLevel::verbose:
-                    [[fallthrough]];
-                case LogLevel::debug:
-                    LOG_DEBUG(message);
-                    break;
-                case LogLevel::silent:
-                    break;
-                default:
-                    break;
+                errorList[taskId] = std::current_exception();
             }
-        });
+        },
+        static_cast<unsigned>(std::min<std::size_t>(nbThread, nbTask)));
+
+    for (const auto &error : errorList)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
 }
 
 class NoPtlChecker: public tmiv::AbstractChecker
@@ -219,8 +270,16 @@ void decodeCommonAtlas(TMIV::MivBitstream::AccessUnit &au, const TMIV::Decoder::
     au.casps = commonAtlasAu.casps;
 }
 
-auto decodeBlockToPatchMap(TMIV::MivBitstream::AccessUnit &au, size_t k, const tmiv::PatchParamsList &ppl)
-    -> tmiv::Frame<tmiv::PatchIdx>
+// Blocks of a map smaller than this are filled on the calling thread only
+constexpr std::size_t minParallelBlockCount = std::size_t{1} << 16U;
+
+// Block-to-patch map of atlas k [9.2.6], filled with one row span per patch and block row. With the patch precedence
+// order flag, the first patch covering a block keeps it, which is what filling patches backward does.
+// Large maps are split in bands of rows filled concurrently, each with all the patches, so overlaps resolve the same.
+auto decodeBlockToPatchMap(const TMIV::MivBitstream::AccessUnit &au,
+                           size_t k,
+                           const tmiv::PatchParamsList &ppl,
+                           unsigned nbThread) -> tmiv::Frame<tmiv::PatchIdx>
 {
     const auto &asps = au.atlas[k].asps;
 
@@ -235,26 +294,57 @@ auto decodeBlockToPatchMap(TMIV::MivBitstream::AccessUnit &au, size_t k, const t
     auto btpm = tmiv::Frame<tmiv::PatchIdx>::lumaOnly({atlasBlockToPatchMapWidth, atlasBlockToPatchMapHeight});
     btpm.fillValue(tmiv::unusedPatchIdx);
 
-    // Then the AtlasBlockToPatchMap array is updated as follows:
+    struct BlockRect
+    {
+        size_t x0, y0, x1, y1;
+        tmiv::PatchIdx patchIdx;
+    };
+
+    const auto mapWidth = static_cast<size_t>(atlasBlockToPatchMapWidth);
+    const auto mapHeight = static_cast<size_t>(atlasBlockToPatchMapHeight);
+    std::vector<BlockRect> rectList;
+
+    rectList.reserve(ppl.size());
+
     for (size_t p = 0; p < ppl.size(); ++p)
     {
         const size_t xOrg = ppl[p].atlasPatch2dPosX() / patchPackingBlockSize;
         const size_t yOrg = ppl[p].atlasPatch2dPosY() / patchPackingBlockSize;
         const size_t atlasPatchWidthBlk = (ppl[p].atlasPatch2dSizeX() + offset) / patchPackingBlockSize;
         const size_t atlasPatchHeightBlk = (ppl[p].atlasPatch2dSizeY() + offset) / patchPackingBlockSize;
+        const auto x1 = std::min(xOrg + atlasPatchWidthBlk, mapWidth);
+        const auto y1 = std::min(yOrg + atlasPatchHeightBlk, mapHeight);
+
+        if ((xOrg < x1) && (yOrg < y1))
+        {
+            rectList.push_back({xOrg, yOrg, x1, y1, static_cast<tmiv::PatchIdx>(p)});
+        }
+    }
+
+    if (asps.asps_patch_precedence_order_flag())
+    {
+        std::reverse(rectList.begin(), rectList.end());
+    }
+
+    auto &plane = btpm.getPlane(0);
 
-        for (size_t y = 0; y < atlasPatchHeightBlk; ++y)
+    const auto fillBand = [&](size_t yBegin, size_t yEnd)
+    {
+        for (const auto &rect : rectList)
         {
-            for (size_t x = 0; x < atlasPatchWidthBlk; ++x)
+            for (auto y = std::max(rect.y0, yBegin); y < std::min(rect.y1, yEnd); ++y)
             {
-                if (!asps.asps_patch_precedence_order_flag() ||
-                    btpm.getPlane(0)(yOrg + y, xOrg + x) == tmiv::unusedPatchIdx)
-                {
-                    btpm.getPlane(0)(yOrg + y, xOrg + x) = static_cast<uint16_t>(p);
-                }
+                std::fill_n(&plane(y, rect.x0), rect.x1 - rect.x0, rect.patchIdx);
             }
         }
-    }
+    };
+
+    const auto nbBand = (minParallelBlockCount <= mapWidth * mapHeight) ? std::min<size_t>(nbThread, mapHeight) : 1;
+
+    runTasks(
+        nbBand,
+        [&](std::size_t bandId) { fillBand(mapHeight * bandId / nbBand, mapHeight * (bandId + 1) / nbBand); },
+        nbThread);
 
     return btpm;
 }
@@ -294,97 +384,201 @@ auto decodePatchParamsList(const TMIV::Decoder::AtlasAccessUnit &atlasAu,
     return ppl;
 }
 
-void decodeAtlas(TMIV::MivBitstream::AccessUnit &au, const TMIV::Decoder::AtlasAccessUnit &atlasAu, size_t k)
+// The block-to-patch map is taken from the previous access unit of the session when the atlas frame and its patches
+// are the same
+void decodeAtlas(TMIV::MivBitstream::AccessUnit &au,
+                 const TMIV::Decoder::AtlasAccessUnit &atlasAu,
+                 size_t k,
+                 const TMIV::MivBitstream::AccessUnit *previous,
+                 unsigned nbThread)
 {
     au.atlas[k].asps = atlasAu.asps;
     au.atlas[k].afps = atlasAu.afps;
     const auto atlasId = au.vps.vps_atlas_id(k);
     const auto &ppl = decodePatchParamsList(atlasAu, au.vps, atlasId, au.atlas[k].patchParamsList);
     requireAllPatchesWithinProjectionPlaneBounds(au.viewParamsList, ppl);
-    au.atlas[k].blockToPatchMap = decodeBlockToPatchMap(au, k, ppl);
+
+    if (previous && (k < previous->atlas.size()) && (previous->atlas[k].asps == au.atlas[k].asps) &&
+        (previous->atlas[k].patchParamsList == ppl))
+    {
+        au.atlas[k].blockToPatchMap = previous->atlas[k].blockToPatchMap;
+    }
+    else
+    {
+        au.atlas[k].blockToPatchMap = decodeBlockToPatchMap(au, k, ppl, nbThread);
+    }
 }
 
-auto decodeVideoPayload(const tmiv::V3cUnitHeader &vuh, std::shared_ptr<TMIV::Decoder::V3cUnitBuffer> inputBuffer)
-    -> std::string
+auto makeInputBuffer(std::string inputData) -> std::shared_ptr<TMIV::Decoder::V3cUnitBuffer>
 {
-    // Adapt the V3C unit buffer to a video sub-bitstream source
-    const auto videoSubBitstreamSource = [&inputBuffer, vuh]() -> std::string
+    std::istringstream inputStream{std::move(inputData)};
+    auto vssDecoder = TMIV::Decoder::decodeV3cSampleStream(inputStream);
+    static constexpr auto onVps = [](auto &&...) {};
+
+    return std::make_shared<TMIV::Decoder::V3cUnitBuffer>(std::move(vssDecoder), onVps);
+}
+
+// V3C unit located in place in a sample stream
+struct V3cUnitView
+{
+    // vuh_unit_type
+    std::uint8_t unitType{};
+    // Size prefix, header and payload
+    ByteSpan sample{};
+    // Header and payload
+    ByteSpan unit{};
+};
+
+auto isMetadataUnit(std::uint8_t unitType) -> bool
+{
+    // V3C_VPS, V3C_AD, V3C_CAD, the others carry video
+    return (unitType == 0) || (unitType == 1) || (unitType == 5);
+}
+
+// Splits a V3C sample stream (ISO/IEC 23090-5 Annex C): a header byte giving the size precision, then sized units
+auto splitSampleStream(ByteSpan inputData, std::vector<V3cUnitView> &unitList) -> bool
+{
+    if (inputData.empty())
     {
-        if (auto v3cUnit = (*inputBuffer)(vuh))
+        return false;
+    }
+
+    const auto precision = static_cast<std::size_t>((inputData[0] >> 5U) + 1U);
+    std::size_t pos = 1;
+
+    while (pos + precision <= inputData.size())
+    {
+        std::size_t unitSize = 0;
+
+        for (std::size_t i = 0; i < precision; i++)
         {
-            return v3cUnit->v3c_unit_payload().video_sub_bitstream().data();
+            unitSize = (unitSize << 8U) | inputData[pos + i];
         }
 
-        return {};
-    };
+        if (inputData.size() - pos - precision < unitSize)
+        {
+            LOG_ERROR("Truncated V3C unit");
+            return false;
+        }
+
+        if (unitSize != 0)
+        {
+            unitList.push_back({static_cast<std::uint8_t>(inputData[pos + precision] >> 3U),
+                                inputData.subspan(pos, precision + unitSize),
+                                inputData.subspan(pos + precision, unitSize)});
+        }
 
-    // Decode video payload
-    std::ostringstream hevc_payload;
+        pos += precision + unitSize;
+    }
 
-    for (auto buffer = videoSubBitstreamSource(); !buffer.empty();)
-    {
-        // Decode the NAL unit size
-        // NOTE(#494): For V3C, LengthSizeMinusOne is equal to 3.
-        std::istringstream stream{buffer.substr(0, 4)};
-        const auto size = tmiv::getUint32(stream);
+    return true;
+}
+
+// Parameter set and atlas units of a segment, as sized samples
+struct MetadataUnits
+{
+    char header{};
+    std::string vps;
+    std::string commonAtlas;
+    std::string atlas;
+
+    // Sample stream holding the parameter set and atlas units only
+    auto toStream() const -> std::string { return header + vps + commonAtlas + atlas; }
+};
 
-        // Decode the payload bytes
-        auto payload = buffer.substr(4, size);
-        VERIFY_V3CBITSTREAM(payload.size() == size);
+auto getMetadataUnits(ByteSpan inputData, const std::vector<V3cUnitView> &unitList) -> MetadataUnits
+{
+    MetadataUnits units;
 
-        // HEVC payload
-        tmiv::putUint8(hevc_payload, 0);
-        tmiv::putUint8(hevc_payload, 0);
-        tmiv::putUint8(hevc_payload, 0);
-        tmiv::putUint8(hevc_payload, 1);
-        hevc_payload << payload;
+    units.header = static_cast<char>(inputData[0]);
 
-        // Update buffer
-        buffer = buffer.substr(4 + size);
+    for (const auto &unit : unitList)
+    {
+        // V3C_VPS = 0, V3C_AD = 1, V3C_CAD = 5
+        auto *group = (unit.unitType == 0)   ? &units.vps
+                      : (unit.unitType == 1) ? &units.atlas
+                      : (unit.unitType == 5) ? &units.commonAtlas
+                                             : nullptr;
 
-        if (buffer.empty())
+        if (group)
         {
-            buffer = videoSubBitstreamSource();
+            group->append(reinterpret_cast<const char *>(unit.sample.data()), unit.sample.size());
         }
     }
 
-    return hevc_payload.str();
+    return units;
 }
 
 } // namespace
 
-auto decodeMivBuffer(std::string inputData)
-    -> std::pair<TMIV::MivBitstream::AccessUnit, std::array<DataPacket, VideoStream::Size>>
+struct SessionState
 {
-    setLoggingStrategy();
+    MetadataUnits units;
+    // Null until a segment decodes
+    MivMetadataPtr au;
+};
 
-    const auto checker = std::make_shared<NoPtlChecker>();
+namespace
+{
+void copyCommonAtlas(TMIV::MivBitstream::AccessUnit &au, const TMIV::MivBitstream::AccessUnit &previous)
+{
+    au.viewParamsList = previous.viewParamsList;
+    au.vui = previous.vui;
+    au.gup = previous.gup;
+    au.vs = previous.vs;
+    au.vcp = previous.vcp;
+    au.vp = previous.vp;
+    au.casps = previous.casps;
+}
 
-    std::istringstream inputStream{std::move(inputData)};
-    auto vssDecoder = TMIV::Decoder::decodeV3cSampleStream(inputStream);
-    static constexpr auto onVps = [](auto &&...) {};
-    auto inputBuffer = std::make_shared<TMIV::Decoder::V3cUnitBuffer>(std::move(vssDecoder), onVps);
+// Decodes the VPS, common atlas and atlas units, returns null when the buffer holds no VPS or fails to decode.
+// Groups of units byte-identical to those of the previous segment of the session are taken from it instead, and
+// when all of them are, the previous access unit itself is returned.
+auto decodeAccessUnit(const MetadataUnits &units, SessionState &state, unsigned nbThread) -> MivMetadataPtr
+{
+    const auto sameVps = state.au && (units.vps == state.units.vps);
+    const auto sameCommonAtlas = sameVps && (units.commonAtlas == state.units.commonAtlas);
 
-    TMIV::MivBitstream::AccessUnit au;
-    //= make_packet<GenericMetadata>();
-    DataPacket occupancyDataPacket;
-    DataPacket geometryDataPacket;
-    DataPacket textureDataPacket;
-    DataPacket transparencyDataPacket;
+    // Patch bounds are checked against the view parameters, so atlas data is reused along with the common atlas
+    if (sameCommonAtlas && (units.atlas == state.units.atlas))
+    {
+        return state.au;
+    }
 
-    //auto &au = mivPacket.getContent();
+    auto previous = std::move(state.au);
+    auto output = std::make_shared<TMIV::MivBitstream::AccessUnit>();
+    auto &au = *output;
 
-    if (auto vuVPS = (*inputBuffer)(tmiv::V3cUnitHeader::vps()))
-    {
-        // IRAP
-        au.foc = 0;
+    const auto checker = std::make_shared<NoPtlChecker>();
+    auto inputBuffer = makeInputBuffer(units.toStream());
+
+    // IRAP
+    au.foc = 0;
 
+    if (sameVps)
+    {
+        au.vps = previous->vps;
+    }
+    else if (auto vuVPS = (*inputBuffer)(tmiv::V3cUnitHeader::vps()))
+    {
         // Decode VPS
         au.vps = vuVPS->v3c_unit_payload().v3c_parameter_set();
         checkCapabilities(au);
+    }
+    else
+    {
+        return {};
+    }
+
+    auto vpsId = au.vps.vps_v3c_parameter_set_id();
 
-        // Decode common atlas data
-        auto vpsId = au.vps.vps_v3c_parameter_set_id();
+    // Decode common atlas data
+    if (sameCommonAtlas)
+    {
+        copyCommonAtlas(au, *previous);
+    }
+    else
+    {
         auto vuhCAD = tmiv::V3cUnitHeader::cad(vpsId);
         auto commonAtlasDecoder = TMIV::Decoder::decodeCommonAtlas(
             TMIV::Decoder::decodeAtlasSubBitstream(TMIV::Decoder::atlasSubBitstreamSource(inputBuffer, vuhCAD)),
@@ -399,114 +593,309 @@ auto decodeMivBuffer(std::string inputData)
             LOG_ERROR("Common atlas data decoding failed");
             return {};
         }
+    }
+
+    // Decode atlas data
+    for (size_t k = 0; k <= au.vps.vps_atlas_count_minus1(); ++k)
+    {
+        const auto atlasId = au.vps.vps_atlas_id(k);
+        auto vuhAD = tmiv::V3cUnitHeader::ad(vpsId, atlasId);
 
-        // Decode atlas data
-        // NOTE: Decode only first atlas
-        au.vps.vps_atlas_count_minus1(0);
-        for (size_t k = 0; k <= au.vps.vps_atlas_count_minus1(); ++k)
+        auto atlasDecoder = TMIV::Decoder::decodeAtlas(
+            TMIV::Decoder::decodeAtlasSubBitstream(TMIV::Decoder::atlasSubBitstreamSource(inputBuffer, vuhAD)),
+            vuhAD,
+            checker);
+
+        au.atlas.emplace_back();
+
+        if (auto atlasAu = atlasDecoder())
+        {
+            decodeAtlas(au, *atlasAu, k, previous.get(), nbThread);
+        }
+        else
         {
-            const auto atlasId = au.vps.vps_atlas_id(k);
-            auto vuhAD = tmiv::V3cUnitHeader::ad(vpsId, atlasId);
+            LOG_ERROR("Atlas data #", k, " decoding failed");
+            return {};
+        }
+    }
+
+    state.units = units;
+    state.au = std::move(output);
 
-            auto atlasDecoder = TMIV::Decoder::decodeAtlas(
-                TMIV::Decoder::decodeAtlasSubBitstream(TMIV::Decoder::atlasSubBitstreamSource(inputBuffer, vuhAD)),
-                vuhAD,
-                checker);
+    return state.au;
+}
 
-            au.atlas.emplace_back();
+using VideoUnitList = std::vector<std::pair<tmiv::V3cUnitHeader, ByteSpan>>;
 
-            if (auto atlasAu = atlasDecoder())
+auto getVideoUnitList(const std::vector<V3cUnitView> &unitList) -> VideoUnitList
+{
+    VideoUnitList videoUnitList;
+
+    for (const auto &unit : unitList)
+    {
+        if (!isMetadataUnit(unit.unitType) && (4 <= unit.unit.size()))
+        {
+            std::istringstream stream{std::string{reinterpret_cast<const char *>(unit.unit.data()), 4}};
+
+            videoUnitList.emplace_back(tmiv::V3cUnitHeader::decodeFrom(stream),
+                                       unit.unit.subspan(4, unit.unit.size() - 4));
+        }
+    }
+
+    return videoUnitList;
+}
+
+// Rewrites the NAL units of the video units matching vuh as one Annex-B buffer, sized before being filled.
+// NOTE(#494): For V3C, LengthSizeMinusOne is equal to 3, so each 4-byte start code replaces a 4-byte NAL unit size.
+auto decodeVideoPayload(const tmiv::V3cUnitHeader &vuh, const VideoUnitList &videoUnitList)
+    -> Descriptor::Data::container_type
+{
+    std::size_t size = 0;
+
+    for (const auto &[header, payload] : videoUnitList)
+    {
+        if (header == vuh)
+        {
+            size += payload.size();
+        }
+    }
+
+    Descriptor::Data::container_type outputData(size);
+    auto *dst = outputData.data();
+
+    for (const auto &[header, payload] : videoUnitList)
+    {
+        // V3cUnitHeader only provides operator==
+        if (!(header == vuh))
+        {
+            continue;
+        }
+
+        for (std::size_t pos = 0; pos < payload.size();)
+        {
+            if (payload.size() - pos < 4)
             {
-                decodeAtlas(au, *atlasAu, k);
+                LOG_ERROR("Truncated NAL unit size");
+                return {};
             }
-            else
+
+            const auto nalSize = (static_cast<std::size_t>(payload[pos]) << 24U) |
+                                 (static_cast<std::size_t>(payload[pos + 1]) << 16U) |
+                                 (static_cast<std::size_t>(payload[pos + 2]) << 8U) | payload[pos + 3];
+
+            if (payload.size() - pos - 4 < nalSize)
             {
-                LOG_ERROR("Atlas data #", k, " decoding failed");
+                LOG_ERROR("Truncated NAL unit");
                 return {};
             }
+
+            dst[0] = 0;
+            dst[1] = 0;
+            dst[2] = 0;
+            dst[3] = 1;
+            std::memcpy(dst + 4, payload.data() + pos + 4, nalSize);
+
+            dst += 4 + nalSize;
+            pos += 4 + nalSize;
         }
+    }
 
-        // Demux occupancy / texture / geometry / transparency video streams
-        for (size_t k = 0; k <= au.vps.vps_atlas_count_minus1(); ++k)
-        {
-            const auto atlasId = au.vps.vps_atlas_id(k);
+    return outputData;
+}
 
-            // Occupancy video stream
-            if (au.vps.vps_occupancy_video_present_flag(atlasId))
+// Video sub-bitstreams of a segment, one per distinct V3C unit header, in order of first appearance
+class VideoSubBitstreamList
+{
+private:
+    std::vector<tmiv::V3cUnitHeader> m_headerList;
+    std::vector<Descriptor::Data::container_type> m_dataList;
+
+public:
+    explicit VideoSubBitstreamList(const VideoUnitList &videoUnitList)
+    {
+        for (const auto &[header, payload] : videoUnitList)
+        {
+            if (std::find(m_headerList.begin(), m_headerList.end(), header) == m_headerList.end())
             {
-                auto vuhOVD = tmiv::V3cUnitHeader::ovd(vpsId, atlasId);
+                m_headerList.push_back(header);
+            }
+        }
 
-                auto data = decodeVideoPayload(vuhOVD, inputBuffer);
+        m_dataList.resize(m_headerList.size());
+    }
+    auto size() const -> std::size_t { return m_headerList.size(); }
+    void extract(std::size_t id, const VideoUnitList &videoUnitList)
+    {
+        m_dataList[id] = decodeVideoPayload(m_headerList[id], videoUnitList);
+    }
+    auto take(const tmiv::V3cUnitHeader &vuh) -> Descriptor::Data::container_type
+    {
+        auto iter = std::find(m_headerList.begin(), m_headerList.end(), vuh);
+        return (iter != m_headerList.end()) ? std::move(m_dataList[std::distance(m_headerList.begin(), iter)])
+                                            : Descriptor::Data::container_type{};
+    }
+};
 
-                if (!data.empty())
-                {
-                    auto ptr = reinterpret_cast<const std::uint8_t *>(data.data());
-                    occupancyDataPacket =
-                        make_packet<Descriptor::Data>(Descriptor::Data::container_type{ptr, ptr + data.size()});
-                }
-                else
-                {
-                    LOG_ERROR("Invalid occupancy data");
-                }
-            }
+} // namespace
 
-            // Geometry video stream
-            if (au.vps.vps_geometry_video_present_flag(atlasId))
+Session::Session()
+    : m_state{std::make_unique<SessionState>()},
+      m_nbThread{std::clamp(std::thread::hardware_concurrency(), 1U, 4U)}
+{
+}
+Session::~Session() = default;
+Session::Session(Session &&) noexcept = default;
+auto Session::operator=(Session &&) noexcept -> Session & = default;
+
+void Session::reset() { *m_state = {}; }
+
+auto Session::decode(ByteSpan inputData) -> std::pair<MivMetadataPtr, AtlasDataPacketList>
+{
+    setLoggingStrategy();
+
+    std::vector<V3cUnitView> unitList;
+
+    if (!splitSampleStream(inputData, unitList))
+    {
+        return {};
+    }
+
+    MivMetadataPtr metadata;
+    AtlasDataPacketList atlasDataPacketList;
+
+    auto metadataUnits = getMetadataUnits(inputData, unitList);
+    auto videoUnitList = getVideoUnitList(unitList);
+    VideoSubBitstreamList videoSubBitstreamList{videoUnitList};
+
+    // TMIV only sees the (small) parameter set and atlas units, video units are read in place.
+    // Task 0 decodes the metadata while the others extract one video sub-bitstream each, in their own slot.
+    runTasks(
+        videoSubBitstreamList.size() + 1,
+        [&](std::size_t taskId)
+        {
+            if (taskId == 0)
             {
-                auto vuhGVD = tmiv::V3cUnitHeader::gvd(vpsId, atlasId);
+                metadata = decodeAccessUnit(metadataUnits, *m_state, m_nbThread);
+            }
+            else
+            {
+                videoSubBitstreamList.extract(taskId - 1, videoUnitList);
+            }
+        },
+        m_nbThread);
 
-                auto data = decodeVideoPayload(vuhGVD, inputBuffer);
+    // Metadata and video come with one entry per atlas, or not at all
+    if (!metadata)
+    {
+        return {};
+    }
 
-                if (!data.empty())
-                {
-                    auto ptr = reinterpret_cast<const std::uint8_t *>(data.data());
-                    geometryDataPacket =
-                        make_packet<Descriptor::Data>(Descriptor::Data::container_type{ptr, ptr + data.size()});
-                }
-                else
-                {
-                    LOG_ERROR("Invalid geometry data");
-                }
+    const auto &au = *metadata;
+    auto vpsId = au.vps.vps_v3c_parameter_set_id();
+
+    atlasDataPacketList.resize(au.vps.vps_atlas_count_minus1() + size_t{1});
+
+    // Demux occupancy / texture / geometry / transparency video streams of each atlas
+    for (size_t k = 0; k <= au.vps.vps_atlas_count_minus1(); ++k)
+    {
+        const auto atlasId = au.vps.vps_atlas_id(k);
+        auto &dataPacketList = atlasDataPacketList[k];
+
+        // Occupancy video stream
+        if (au.vps.vps_occupancy_video_present_flag(atlasId))
+        {
+            auto vuhOVD = tmiv::V3cUnitHeader::ovd(vpsId, atlasId);
+
+            auto data = videoSubBitstreamList.take(vuhOVD);
+
+            if (!data.empty())
+            {
+                dataPacketList[VideoStream::Occupancy] = make_packet<Descriptor::Data>(std::move(data));
             }
+            else
+            {
+                LOG_ERROR("Invalid occupancy data (atlas #", k, ")");
+            }
+        }
 
-            // Attribute video streams
-            const auto &ai = au.vps.attribute_information(atlasId);
+        // Geometry video stream
+        if (au.vps.vps_geometry_video_present_flag(atlasId))
+        {
+            auto vuhGVD = tmiv::V3cUnitHeader::gvd(vpsId, atlasId);
+
+            auto data = videoSubBitstreamList.take(vuhGVD);
 
-            for (std::uint8_t attributeIndex = 0; attributeIndex < ai.ai_attribute_count(); ++attributeIndex)
+            if (!data.empty())
             {
-                auto vuhAVD = tmiv::V3cUnitHeader::avd(vpsId, atlasId, attributeIndex);
+                dataPacketList[VideoStream::Geometry] = make_packet<Descriptor::Data>(std::move(data));
+            }
+            else
+            {
+                LOG_ERROR("Invalid geometry data (atlas #", k, ")");
+            }
+        }
 
-                std::string data = decodeVideoPayload(vuhAVD, inputBuffer);
+        // Attribute video streams
+        const auto &ai = au.vps.attribute_information(atlasId);
 
-                if (!data.empty())
+        for (std::uint8_t attributeIndex = 0; attributeIndex < ai.ai_attribute_count(); ++attributeIndex)
+        {
+            auto vuhAVD = tmiv::V3cUnitHeader::avd(vpsId, atlasId, attributeIndex);
+
+            auto data = videoSubBitstreamList.take(vuhAVD);
+
+            if (!data.empty())
+            {
+                auto type = ai.ai_attribute_type_id(attributeIndex);
+
+                if (type == tmiv::AiAttributeTypeId::ATTR_TEXTURE)
                 {
-                    auto ptr = reinterpret_cast<const std::uint8_t *>(data.data());
-                    auto type = ai.ai_attribute_type_id(attributeIndex);
-
-                    if (type == tmiv::AiAttributeTypeId::ATTR_TEXTURE)
-                    {
-                        textureDataPacket =
-                            make_packet<Descriptor::Data>(Descriptor::Data::container_type{ptr, ptr + data.size()});
-                    }
-                    else if (type == tmiv::AiAttributeTypeId::ATTR_TRANSPARENCY)
-                    {
-                        transparencyDataPacket =
-                            make_packet<Descriptor::Data>(Descriptor::Data::container_type{ptr, ptr + data.size()});
-                    }
+                    dataPacketList[VideoStream::Texture] = make_packet<Descriptor::Data>(std::move(data));
                 }
-                else
+                else if (type == tmiv::AiAttributeTypeId::ATTR_TRANSPARENCY)
                 {
-                    LOG_ERROR("Invalid attribute data");
-                    return {};
+                    dataPacketList[VideoStream::Transparency] = make_packet<Descriptor::Data>(std::move(data));
                 }
             }
+            else
+            {
+                LOG_ERROR("Invalid attribute data (atlas #", k, ")");
+                return {};
+            }
         }
     }
 
-    return {std::move(au),
-            {std::move(occupancyDataPacket),
-             std::move(geometryDataPacket),
-             std::move(textureDataPacket),
-             std::move(transparencyDataPacket)}};
+    return {std::move(metadata), std::move(atlasDataPacketList)};
+}
+
+auto Session::decodeMetadata(ByteSpan inputData) -> MivMetadataPtr
+{
+    setLoggingStrategy();
+
+    std::vector<V3cUnitView> unitList;
+
+    if (!splitSampleStream(inputData, unitList))
+    {
+        return {};
+    }
+
+    return decodeAccessUnit(getMetadataUnits(inputData, unitList), *m_state, m_nbThread);
+}
+
+auto decodeMivBuffer(ByteSpan inputData) -> std::pair<MivMetadataPtr, AtlasDataPacketList>
+{
+    return Session{}.decode(inputData);
+}
+
+auto extractMivMetadata(ByteSpan inputData) -> std::string
+{
+    std::vector<V3cUnitView> unitList;
+
+    if (!splitSampleStream(inputData, unitList))
+    {
+        return {};
+    }
+
+    return getMetadataUnits(inputData, unitList).toStream();
 }
 } // namespace miv
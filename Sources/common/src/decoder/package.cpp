@@ -0,0 +1,361 @@
+/*
+* Copyright (c) 2025 InterDigital CE Patent Holdings SASU
+* Licensed under the License terms of 5GMAG software (the "License").
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at https://www.5g-mag.com/license .
+* Unless required by applicable law or agreed to in writing, software distributed under the License is
+* distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and limitations under the License.
+*/
+
+#include <algorithm>
+#include <common/decoder/miv.h>
+#include <common/decoder/package.h>
+#include <common/misc/span.h>
+#include <common/stream/chunk.h>
+#include <cstring>
+#include <stdexcept>
+
+using namespace iloj::misc;
+using namespace iloj::media;
+
+// Layout (little-endian):
+//   header   "V3CP" | version u8 | typeId u8 | reserved u16 | nbFrame u32 | duration f64
+//            | video size u64 x VideoStream::Size | metadata size u64
+//   payload  video sub-bitstreams (Annex-B) in VideoStream order | metadata
+// V-PCC metadata:
+//   nbFrame u32, then per frame: frame_index i32 | frame_width i32 | frame_height i32
+//            | nbPatch u32 | U0 V0 U1 V1 D1 NormalAxis PatchOrientation ProjectionMode u16 x nbPatch
+//            | nbBlock u32 | blockToPatch u16 x nbBlock
+// The patch table padding is not stored (see vpccMetadataLayoutVersion).
+namespace package
+{
+namespace
+{
+constexpr std::array<std::uint8_t, 4> magic = {'V', '3', 'C', 'P'};
+constexpr std::uint8_t version = 2;
+constexpr std::size_t headerSize = 4 + 1 + 1 + 2 + 4 + 8 + 8 * VideoStream::Size + 8;
+
+class Writer
+{
+private:
+    std::vector<std::uint8_t> &m_buffer;
+
+public:
+    explicit Writer(std::vector<std::uint8_t> &buffer): m_buffer{buffer} {}
+    template<typename T>
+    void put(T value)
+    {
+        static_assert(std::is_integral_v<T>);
+
+        for (std::size_t i = 0; i < sizeof(T); i++)
+        {
+            m_buffer.push_back(static_cast<std::uint8_t>(static_cast<std::uint64_t>(value) >> (8U * i)));
+        }
+    }
+    void put(double value)
+    {
+        std::uint64_t bits{};
+        std::memcpy(&bits, &value, sizeof(bits));
+        put(bits);
+    }
+    void put(const std::uint8_t *data, std::size_t size) { m_buffer.insert(m_buffer.end(), data, data + size); }
+};
+
+class Reader
+{
+private:
+    const std::uint8_t *m_data{};
+    std::size_t m_size{};
+    std::size_t m_pos{};
+
+public:
+    Reader(const std::uint8_t *data, std::size_t size): m_data{data}, m_size{size} {}
+    template<typename T>
+    auto get() -> T
+    {
+        static_assert(std::is_integral_v<T>);
+
+        std::uint64_t value{};
+
+        for (std::size_t i = 0; i < sizeof(T); i++)
+        {
+            value |= static_cast<std::uint64_t>(m_data[reserve(1)]) << (8U * i);
+        }
+
+        return static_cast<T>(value);
+    }
+    auto getDouble() -> double
+    {
+        auto bits = get<std::uint64_t>();
+        double value{};
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    auto get(std::size_t size) -> const std::uint8_t * { return m_data + reserve(size); }
+
+private:
+    auto reserve(std::size_t size) -> std::size_t
+    {
+        if (m_size - m_pos < size)
+        {
+            throw std::runtime_error("Truncated V3C package");
+        }
+
+        auto pos = m_pos;
+        m_pos += size;
+
+        return pos;
+    }
+};
+
+void encodeVpccMetadata(Writer &writer, const std::vector<VpccMetadata> &metadataList)
+{
+    writer.put(static_cast<std::uint32_t>(metadataList.size()));
+
+    for (const auto &metadata : metadataList)
+    {
+        writer.put(static_cast<std::int32_t>(metadata.frame_index));
+        writer.put(static_cast<std::int32_t>(metadata.frame_width));
+        writer.put(static_cast<std::int32_t>(metadata.frame_height));
+        const common::misc::Span<const VpccPatchMetadata> patchList{
+            metadata.patchBlockBuffers.data(),
+            std::min<std::size_t>(metadata.patch_count, metadata.patchBlockBuffers.size())};
+
+        writer.put(static_cast<std::uint32_t>(patchList.size()));
+
+        for (const auto &patch : patchList)
+        {
+            for (auto value : {patch.U0,
+                               patch.V0,
+                               patch.U1,
+                               patch.V1,
+                               patch.D1,
+                               patch.NormalAxis,
+                               patch.PatchOrientation,
+                               patch.ProjectionMode})
+            {
+                writer.put(value);
+            }
+        }
+
+        writer.put(static_cast<std::uint32_t>(metadata.blockToPatch.size()));
+
+        for (auto patchId : metadata.blockToPatch)
+        {
+            writer.put(patchId);
+        }
+    }
+}
+
+auto decodeVpccMetadata(Reader &reader) -> std::vector<VpccMetadata>
+{
+    std::vector<VpccMetadata> metadataList(reader.get<std::uint32_t>());
+
+    for (auto &metadata : metadataList)
+    {
+        metadata.frame_index = reader.get<std::int32_t>();
+        metadata.frame_width = reader.get<std::int32_t>();
+        metadata.frame_height = reader.get<std::int32_t>();
+        metadata.patch_count = static_cast<int>(reader.get<std::uint32_t>());
+
+        if (vpccMaxPatchCount < static_cast<std::size_t>(metadata.patch_count))
+        {
+            throw std::runtime_error("Invalid V3C package metadata");
+        }
+
+        metadata.patchBlockBuffers.resize(getVpccPatchTableSize(metadata.patch_count));
+
+        for (auto &patch : common::misc::Span<VpccPatchMetadata>{metadata.patchBlockBuffers.data(),
+                                                                 static_cast<std::size_t>(metadata.patch_count)})
+        {
+            for (auto *value : {&patch.U0,
+                                &patch.V0,
+                                &patch.U1,
+                                &patch.V1,
+                                &patch.D1,
+                                &patch.NormalAxis,
+                                &patch.PatchOrientation,
+                                &patch.ProjectionMode})
+            {
+                *value = reader.get<std::uint16_t>();
+            }
+        }
+
+        metadata.blockToPatch.resize(reader.get<std::uint32_t>());
+
+        for (auto &patchId : metadata.blockToPatch)
+        {
+            patchId = reader.get<std::uint16_t>();
+        }
+    }
+
+    return metadataList;
+}
+
+} // namespace
+
+auto isPackage(const std::uint8_t *data, std::size_t size) -> bool
+{
+    return (headerSize <= size) && (std::memcmp(data, magic.data(), magic.size()) == 0);
+}
+
+auto encode(const Segment &segment) -> std::vector<std::uint8_t>
+{
+    std::vector<std::uint8_t> metadata;
+    Writer metadataWriter{metadata};
+
+    if (segment.typeId == Chunk::Header::TypeId::Miv)
+    {
+        metadataWriter.put(reinterpret_cast<const std::uint8_t *>(segment.mivMetadata.data()),
+                           segment.mivMetadata.size());
+    }
+    else if (segment.typeId == Chunk::Header::TypeId::Vpcc)
+    {
+        encodeVpccMetadata(metadataWriter, segment.vpccMetadata);
+    }
+    else
+    {
+        throw std::runtime_error("Only MIV and V-PCC segments can be packaged");
+    }
+
+    std::vector<std::uint8_t> buffer;
+    Writer writer{buffer};
+
+    writer.put(magic.data(), magic.size());
+    writer.put(version);
+    writer.put(segment.typeId);
+    writer.put(std::uint16_t{});
+    writer.put(segment.nbFrame);
+    writer.put(segment.duration);
+
+    for (const auto &videoDataPacket : segment.videoDataPacketList)
+    {
+        writer.put(static_cast<std::uint64_t>(videoDataPacket ? videoDataPacket->getFrame().size() : 0));
+    }
+
+    writer.put(static_cast<std::uint64_t>(metadata.size()));
+
+    for (const auto &videoDataPacket : segment.videoDataPacketList)
+    {
+        if (videoDataPacket)
+        {
+            writer.put(videoDataPacket->getFrame().data(), videoDataPacket->getFrame().size());
+        }
+    }
+
+    writer.put(metadata.data(), metadata.size());
+
+    return buffer;
+}
+
+auto decode(const std::uint8_t *data, std::size_t size) -> Segment
+{
+    if (!isPackage(data, size))
+    {
+        throw std::runtime_error("Not a V3C package");
+    }
+
+    Reader reader{data, size};
+    Segment segment;
+
+    reader.get(magic.size());
+
+    if (reader.get<std::uint8_t>() != version)
+    {
+        throw std::runtime_error("Unsupported V3C package version");
+    }
+
+    segment.typeId = reader.get<std::uint8_t>();
+    reader.get<std::uint16_t>();
+    segment.nbFrame = reader.get<std::uint32_t>();
+    segment.duration = reader.getDouble();
+
+    std::array<std::uint64_t, VideoStream::Size> videoSizeList{};
+
+    for (auto &videoSize : videoSizeList)
+    {
+        videoSize = reader.get<std::uint64_t>();
+    }
+
+    auto metadataSize = reader.get<std::uint64_t>();
+
+    for (std::size_t videoStreamId = 0; videoStreamId < VideoStream::Size; videoStreamId++)
+    {
+        if (auto videoSize = static_cast<std::size_t>(videoSizeList[videoStreamId]); videoSize != 0)
+        {
+            const auto *ptr = reader.get(videoSize);
+
+            segment.videoDataPacketList[videoStreamId] =
+                make_packet<Descriptor::Data>(Descriptor::Data::container_type{ptr, ptr + videoSize});
+        }
+    }
+
+    Reader metadataReader{reader.get(static_cast<std::size_t>(metadataSize)), static_cast<std::size_t>(metadataSize)};
+
+    if (segment.typeId == Chunk::Header::TypeId::Miv)
+    {
+        const auto *ptr = metadataReader.get(static_cast<std::size_t>(metadataSize));
+        segment.mivMetadata.assign(reinterpret_cast<const char *>(ptr), static_cast<std::size_t>(metadataSize));
+    }
+    else if (segment.typeId == Chunk::Header::TypeId::Vpcc)
+    {
+        segment.vpccMetadata = decodeVpccMetadata(metadataReader);
+    }
+
+    return segment;
+}
+
+auto readProperty(const std::uint8_t *data, std::size_t size) -> std::pair<double, std::uint32_t>
+{
+    if (!isPackage(data, size))
+    {
+        throw std::runtime_error("Not a V3C package");
+    }
+
+    Reader reader{data, size};
+
+    reader.get(magic.size() + 4);
+
+    auto nbFrame = reader.get<std::uint32_t>();
+    auto duration = reader.getDouble();
+
+    return {duration, nbFrame};
+}
+
+auto decodeMivPackage(const std::uint8_t *data, std::size_t size, miv::Session &session)
+    -> std::pair<MivMetadataPtr, miv::AtlasDataPacketList>
+{
+    auto segment = decode(data, size);
+
+    if (segment.typeId != Chunk::Header::TypeId::Miv)
+    {
+        throw std::runtime_error("V3C package does not hold MIV content");
+    }
+
+    const auto *metadata = reinterpret_cast<const std::uint8_t *>(segment.mivMetadata.data());
+
+    auto au = session.decodeMetadata({metadata, segment.mivMetadata.size()});
+
+    if (au && (1 < au->atlas.size()))
+    {
+        throw std::runtime_error("V3C package holds a multi-atlas MIV segment");
+    }
+
+    return {std::move(au), {std::move(segment.videoDataPacketList)}};
+}
+
+auto decodeVpccPackage(const std::uint8_t *data, std::size_t size)
+    -> std::pair<std::vector<VpccMetadata>, std::array<DataPacket, VideoStream::Size>>
+{
+    auto segment = decode(data, size);
+
+    if (segment.typeId != Chunk::Header::TypeId::Vpcc)
+    {
+        throw std::runtime_error("V3C package does not hold V-PCC content");
+    }
+
+    return {std::move(segment.vpccMetadata), std::move(segment.videoDataPacketList)};
+}
+} // namespace package
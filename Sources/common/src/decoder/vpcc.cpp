@@ -9,6 +9,7 @@
 * See the License for the specific language governing permissions and limitations under the License.
 */
 
+#if defined TMC2_VPCC_PARSER
 #include "PCCBitstream.h"
 #include "PCCBitstreamReader.h"
 #include "PCCContext.h"
@@ -17,29 +18,1216 @@
 #include "PCCHighLevelSyntax.h"
 #include "PCCPatch.h"
 #include "PCCSampleStreamV3CUnit.h"
+#endif
 
+#include <algorithm>
 #include <common/decoder/vpcc.h>
+#include <cstring>
+#include <deque>
+#include <functional>
 #include <iloj/misc/logger.h>
+#include <iloj/misc/thread.h>
+#include <memory>
+#include <optional>
+#include <stdexcept>
 
 using namespace iloj::misc;
 using namespace iloj::media;
-using namespace pcc;
+using common::misc::ByteSpan;
+
+auto getVpccVideoStreamName(int videoStreamId) -> const std::string &
+{
+    static std::array<std::string, VideoStream::Size> videoStreamNameList = {
+        "Occupancy", "Geometry", "Texture", "Transparency"};
+
+    return videoStreamNameList[videoStreamId];
+}
+
+// Syntax and semantics of ISO/IEC 23090-5 (V3C), restricted to what VpccMetadata is made of
+namespace vpcc
+{
+namespace
+{
+// vuh_unit_type
+enum UnitType : std::uint32_t
+{
+    V3C_VPS = 0,
+    V3C_AD,
+    V3C_OVD,
+    V3C_GVD,
+    V3C_AVD,
+    V3C_CAD
+};
+
+// nal_unit_type, ACL types are those below NAL_ASPS
+enum NalUnitType : std::uint32_t
+{
+    NAL_BLA_W_LP = 16,
+    NAL_CRA = 26,
+    NAL_RSV_IRAP_ACL_29 = 29,
+    NAL_ASPS = 36,
+    NAL_AFPS
+};
+
+// ath_type
+enum TileType : std::uint32_t
+{
+    P_TILE = 0,
+    I_TILE,
+    SKIP_TILE
+};
+
+// atdu_patch_mode in I_TILE
+enum IntraPatchMode : std::uint32_t
+{
+    I_INTRA = 0,
+    I_RAW,
+    I_EOM,
+    I_END = 14
+};
+
+// atdu_patch_mode in P_TILE
+enum InterPatchMode : std::uint32_t
+{
+    P_SKIP = 0,
+    P_MERGE,
+    P_INTER,
+    P_INTRA,
+    P_RAW,
+    P_EOM,
+    P_END = 14
+};
+
+constexpr std::size_t maxAspsCount = 16;
+constexpr std::size_t maxAfpsCount = 64;
+
+auto ceilLog2(std::uint32_t value) -> unsigned
+{
+    unsigned nbBit = 0;
+
+    while ((std::uint64_t{1} << nbBit) < value)
+    {
+        nbBit++;
+    }
+
+    return nbBit;
+}
+
+auto floorLog2(std::uint32_t value) -> unsigned { return ceilLog2(value + 1) - 1; }
+
+// MSB-first reader of an RBSP
+class BitReader
+{
+private:
+    const std::uint8_t *m_data{};
+    std::size_t m_size{};
+    std::size_t m_bitPos{};
+
+public:
+    BitReader(const std::uint8_t *data, std::size_t size): m_data{data}, m_size{size} {}
+    auto read(unsigned nbBit) -> std::uint32_t
+    {
+        if ((32 < nbBit) || (m_size * 8 - m_bitPos < nbBit))
+        {
+            throw std::runtime_error("Truncated V-PCC atlas data");
+        }
+
+        std::uint32_t value = 0;
+
+        for (unsigned i = 0; i < nbBit; i++, m_bitPos++)
+        {
+            value = (value << 1U) | ((m_data[m_bitPos / 8] >> (7U - m_bitPos % 8)) & 1U);
+        }
+
+        return value;
+    }
+    auto readFlag() -> bool { return read(1) != 0; }
+    auto readUe() -> std::uint32_t
+    {
+        unsigned nbZero = 0;
+
+        while (!readFlag())
+        {
+            if (31 < ++nbZero)
+            {
+                throw std::runtime_error("Invalid exp-Golomb code in V-PCC atlas data");
+            }
+        }
+
+        return ((std::uint32_t{1} << nbZero) - 1) + read(nbZero);
+    }
+    auto readSe() -> std::int64_t
+    {
+        auto code = static_cast<std::int64_t>(readUe());
+        return (code & 1) ? (code + 1) / 2 : -(code / 2);
+    }
+    // byte_alignment(): a one bit, then zero bits up to the byte boundary
+    void alignByte()
+    {
+        read(1);
+        read(static_cast<unsigned>((8 - m_bitPos % 8) % 8));
+    }
+};
+
+// NAL unit payload without its emulation prevention bytes (0x000003), into a buffer reused from one unit to the next
+void extractRbsp(ByteSpan payload, std::vector<std::uint8_t> &rbsp)
+{
+    rbsp.clear();
+
+    unsigned nbZero = 0;
+
+    for (auto byte : payload)
+    {
+        if ((2 <= nbZero) && (byte == 3))
+        {
+            nbZero = 0;
+            continue;
+        }
+
+        nbZero = (byte == 0) ? nbZero + 1 : 0;
+        rbsp.push_back(byte);
+    }
+}
+
+// Sized samples of a sample stream (Annex C / Annex D): a header byte giving the size precision, then the samples.
+// Both V3C units and atlas NAL units are stored that way.
+auto splitSampleStream(ByteSpan inputData) -> std::vector<ByteSpan>
+{
+    std::vector<ByteSpan> sampleList;
+
+    if (inputData.empty())
+    {
+        return sampleList;
+    }
+
+    const auto precision = static_cast<std::size_t>((inputData[0] >> 5U) + 1U);
+
+    for (std::size_t pos = 1; pos + precision <= inputData.size();)
+    {
+        std::size_t sampleSize = 0;
+
+        for (std::size_t i = 0; i < precision; i++)
+        {
+            sampleSize = (sampleSize << 8U) | inputData[pos + i];
+        }
+
+        pos += precision;
+
+        if (inputData.size() - pos < sampleSize)
+        {
+            throw std::runtime_error("Truncated V-PCC sample stream");
+        }
+
+        if (sampleSize != 0)
+        {
+            sampleList.push_back(inputData.subspan(pos, sampleSize));
+        }
+
+        pos += sampleSize;
+    }
+
+    return sampleList;
+}
+
+struct RefListStruct
+{
+    struct Entry
+    {
+        bool shortTerm{true};
+        // Short-term: AFOC difference with the previous short-term entry (the current frame for the first one)
+        std::int64_t deltaAfoc{};
+        // Long-term: AFOC LSBs
+        std::uint32_t afocLsb{};
+    };
+
+    std::vector<Entry> entryList;
+};
+
+struct PlrMap
+{
+    bool present{};
+    std::uint32_t nbModeMinus1{};
+    std::uint32_t blockThresholdPerPatchMinus1{};
+};
+
+struct Asps
+{
+    std::uint32_t frameWidth{};
+    std::uint32_t frameHeight{};
+    std::uint32_t geometry3dBitDepthMinus1{};
+    std::uint32_t geometry2dBitDepthMinus1{};
+    unsigned log2MaxAfocLsb{};
+    std::uint32_t maxDecAtlasFrameBufferingMinus1{};
+    bool longTermRefAtlasFrames{};
+    std::vector<RefListStruct> refListList;
+    bool useEightOrientations{};
+    bool extendedProjection{};
+    std::uint32_t maxNbProjectionMinus1{};
+    bool normalAxisLimitsQuantization{};
+    bool normalAxisMaxDeltaValue{};
+    bool patchPrecedenceOrder{};
+    unsigned log2PatchPackingBlockSize{};
+    bool patchSizeQuantizerPresent{};
+    std::uint32_t mapCountMinus1{};
+    bool auxiliaryVideo{};
+    bool plr{};
+    std::vector<PlrMap> plrMapList;
+};
+
+struct Afps
+{
+    std::uint32_t aspsId{};
+    unsigned tileIdLength{};
+    std::uint32_t auxiliaryTileHeight{};
+    bool outputFlagPresent{};
+    std::uint32_t numRefIdxDefaultActiveMinus1{};
+    unsigned additionalLtAfocLsbLength{};
+    bool lodMode{};
+    bool raw3dOffsetBitCountExplicitMode{};
+};
+
+// Patch as reconstructed from its data unit and its reference patch, if any.
+// Position in patch packing blocks, size in pixels (TilePatch2dSizeX / Y), 3D offsets in geometry units.
+struct Patch
+{
+    std::int64_t posX{};
+    std::int64_t posY{};
+    std::int64_t sizeX{};
+    std::int64_t sizeY{};
+    std::int64_t offsetU{};
+    std::int64_t offsetV{};
+    std::int64_t offsetD{};
+    std::uint32_t projectionId{};
+    std::uint32_t orientation{};
+};
+
+struct AtlasFrame
+{
+    std::int64_t afoc{};
+    std::vector<Patch> patchList;
+};
+
+struct TileHeader
+{
+    std::uint32_t type{};
+    unsigned posMinDQuantizer{};
+    unsigned posDeltaMaxDQuantizer{};
+    std::int64_t patchSizeXQuantizer{};
+    std::int64_t patchSizeYQuantizer{};
+    unsigned raw3dOffsetBitCount{};
+    std::uint32_t numRefIdxActive{};
+    std::vector<const AtlasFrame *> refFrameList;
+
+    auto getRefFrame(std::uint32_t refIdx) const -> const AtlasFrame &
+    {
+        if ((refFrameList.size() <= refIdx) || !refFrameList[refIdx])
+        {
+            throw std::runtime_error("Missing V-PCC reference atlas frame");
+        }
+
+        return *refFrameList[refIdx];
+    }
+};
+
+auto getRefPatch(const AtlasFrame &refFrame, std::int64_t refPatchIdx) -> const Patch &
+{
+    if ((refPatchIdx < 0) || (static_cast<std::int64_t>(refFrame.patchList.size()) <= refPatchIdx))
+    {
+        throw std::runtime_error("Invalid V-PCC reference patch");
+    }
+
+    return refFrame.patchList[static_cast<std::size_t>(refPatchIdx)];
+}
+
+auto parseRefListStruct(BitReader &reader, const Asps &asps) -> RefListStruct
+{
+    RefListStruct refList;
+
+    refList.entryList.resize(reader.readUe());
+
+    for (auto &entry : refList.entryList)
+    {
+        entry.shortTerm = !asps.longTermRefAtlasFrames || reader.readFlag();
+
+        if (entry.shortTerm)
+        {
+            auto absDelta = static_cast<std::int64_t>(reader.readUe());
+            entry.deltaAfoc = ((absDelta != 0) && !reader.readFlag()) ? -absDelta : absDelta;
+        }
+        else
+        {
+            entry.afocLsb = reader.read(asps.log2MaxAfocLsb);
+        }
+    }
+
+    return refList;
+}
+
+// Atlas sub-bitstream parser, keeping the last decoded frames as references of the following ones
+// Runs task(0) ... task(nbFrame - 1) on up to nbThread threads, each task writing to its own frame only
+void runFrameTasks(std::size_t nbFrame, const std::function<void(std::size_t)> &task, unsigned nbThread)
+{
+    if ((nbThread <= 1) || (nbFrame <= 1))
+    {
+        for (std::size_t frameIdx = 0; frameIdx < nbFrame; frameIdx++)
+        {
+            task(frameIdx);
+        }
+
+        return;
+    }
+
+    parallel_for(nbFrame, task, static_cast<unsigned>(std::min<std::size_t>(nbThread, nbFrame)));
+}
+
+class AtlasParser
+{
+private:
+    // Frame with at least one patch, waiting for its metadata to be extracted
+    struct PendingFrame
+    {
+        std::shared_ptr<const Asps> asps;
+        std::vector<Patch> patchList;
+    };
+
+    // Shared with the pending frames, a parameter set may be replaced once they are parsed
+    std::array<std::shared_ptr<const Asps>, maxAspsCount> m_aspsList;
+    std::array<std::optional<Afps>, maxAfpsCount> m_afpsList;
+    std::deque<AtlasFrame> m_frameList;
+    std::int64_t m_prevAfoc{};
+    std::vector<std::uint8_t> m_rbsp;
+    std::vector<PendingFrame> m_pendingList;
+
+public:
+    void parse(ByteSpan atlasSubBitstream)
+    {
+        for (const auto &nalUnit : splitSampleStream(atlasSubBitstream))
+        {
+            // forbidden_zero_bit, nal_unit_type, nal_layer_id, nal_temporal_id_plus1
+            if ((nalUnit.size() < 2) || ((((nalUnit[0] & 1U) << 5U) | (nalUnit[1] >> 3U)) != 0))
+            {
+                continue;
+            }
+
+            const auto nalType = static_cast<std::uint32_t>((nalUnit[0] >> 1U) & 0x3FU);
+
+            extractRbsp(nalUnit.subspan(2, nalUnit.size() - 2), m_rbsp);
+            BitReader reader{m_rbsp.data(), m_rbsp.size()};
+
+            if (nalType == NAL_ASPS)
+            {
+                parseAsps(reader);
+            }
+            else if (nalType == NAL_AFPS)
+            {
+                parseAfps(reader);
+            }
+            else if (nalType < NAL_ASPS)
+            {
+                parseTileLayer(nalType, reader);
+            }
+        }
+    }
+    // Metadata of the frames parsed so far, in decoding order. Frames only depend on each other through their patch
+    // lists: their maps are then filled independently, on up to nbThread threads.
+    auto takeMetadataList(unsigned nbThread) -> std::vector<VpccMetadata>
+    {
+        std::vector<VpccMetadata> metadataList(m_pendingList.size());
+
+        runFrameTasks(
+            metadataList.size(),
+            [&](std::size_t frameIdx)
+            {
+                const auto &pending = m_pendingList[frameIdx];
+                metadataList[frameIdx] = toMetadata(pending.patchList, *pending.asps, static_cast<int>(frameIdx));
+            },
+            nbThread);
+
+        m_pendingList.clear();
+
+        return metadataList;
+    }
+
+private:
+    auto getAsps(std::uint32_t aspsId) const -> const std::shared_ptr<const Asps> &
+    {
+        if ((maxAspsCount <= aspsId) || !m_aspsList[aspsId])
+        {
+            throw std::runtime_error("Missing V-PCC atlas sequence parameter set");
+        }
+
+        return m_aspsList[aspsId];
+    }
+    auto getAfps(std::uint32_t afpsId) const -> const Afps &
+    {
+        if ((maxAfpsCount <= afpsId) || !m_afpsList[afpsId])
+        {
+            throw std::runtime_error("Missing V-PCC atlas frame parameter set");
+        }
+
+        return *m_afpsList[afpsId];
+    }
+    void parseAsps(BitReader &reader)
+    {
+        Asps asps;
+
+        const auto aspsId = reader.readUe();
+
+        asps.frameWidth = reader.readUe();
+        asps.frameHeight = reader.readUe();
+        asps.geometry3dBitDepthMinus1 = reader.read(5);
+        asps.geometry2dBitDepthMinus1 = reader.read(5);
+        asps.log2MaxAfocLsb = reader.readUe() + 4;
+        asps.maxDecAtlasFrameBufferingMinus1 = reader.readUe();
+        asps.longTermRefAtlasFrames = reader.readFlag();
+
+        asps.refListList.resize(reader.readUe());
+
+        for (auto &refList : asps.refListList)
+        {
+            refList = parseRefListStruct(reader, asps);
+        }
+
+        asps.useEightOrientations = reader.readFlag();
+        asps.extendedProjection = reader.readFlag();
+
+        if (asps.extendedProjection)
+        {
+            asps.maxNbProjectionMinus1 = reader.readUe();
+        }
+
+        asps.normalAxisLimitsQuantization = reader.readFlag();
+        asps.normalAxisMaxDeltaValue = reader.readFlag();
+        asps.patchPrecedenceOrder = reader.readFlag();
+        asps.log2PatchPackingBlockSize = reader.read(3);
+        asps.patchSizeQuantizerPresent = reader.readFlag();
+        asps.mapCountMinus1 = reader.read(4);
+
+        // asps_pixel_deinterleaving_enabled_flag, asps_map_pixel_deinterleaving_flag
+        if (reader.readFlag())
+        {
+            reader.read(asps.mapCountMinus1 + 1);
+        }
+
+        const auto rawPatch = reader.readFlag();
+        const auto eomPatch = reader.readFlag();
+
+        if (eomPatch && (asps.mapCountMinus1 == 0))
+        {
+            // asps_eom_fix_bit_count_minus1
+            reader.read(4);
+        }
+
+        if (rawPatch || eomPatch)
+        {
+            asps.auxiliaryVideo = reader.readFlag();
+        }
+
+        asps.plr = reader.readFlag();
+
+        if (asps.plr)
+        {
+            asps.plrMapList.resize(asps.mapCountMinus1 + 1);
+
+            for (auto &plrMap : asps.plrMapList)
+            {
+                plrMap.present = reader.readFlag();
+
+                if (plrMap.present)
+                {
+                    plrMap.nbModeMinus1 = reader.read(4);
+                    // plri_interpolate_flag, plri_filling_flag, plri_minimum_depth, plri_neighbour_minus1
+                    reader.read(6 * (plrMap.nbModeMinus1 + 1));
+                    plrMap.blockThresholdPerPatchMinus1 = reader.read(6);
+                }
+            }
+        }
+
+        // VUI and extensions are not needed
+        if (maxAspsCount <= aspsId)
+        {
+            throw std::runtime_error("Invalid V-PCC atlas sequence parameter set id");
+        }
+
+        m_aspsList[aspsId] = std::make_shared<const Asps>(std::move(asps));
+    }
+    void parseAfps(BitReader &reader)
+    {
+        Afps afps;
+
+        const auto afpsId = reader.readUe();
+
+        afps.aspsId = reader.readUe();
+
+        const auto &asps = *getAsps(afps.aspsId);
+
+        // atlas_frame_tile_information()
+        if (!reader.readFlag())
+        {
+            throw std::runtime_error("Multi-tile V-PCC atlas frames are not supported");
+        }
+
+        if (asps.auxiliaryVideo)
+        {
+            // afti_auxiliary_video_tile_row_width_minus1
+            reader.readUe();
+            afps.auxiliaryTileHeight = reader.readUe();
+        }
+
+        if (reader.readFlag())
+        {
+            afps.tileIdLength = reader.readUe() + 1;
+            // afti_tile_id
+            reader.read(afps.tileIdLength);
+        }
+
+        afps.outputFlagPresent = reader.readFlag();
+        afps.numRefIdxDefaultActiveMinus1 = reader.readUe();
+        afps.additionalLtAfocLsbLength = reader.readUe();
+        afps.lodMode = reader.readFlag();
+        afps.raw3dOffsetBitCountExplicitMode = reader.readFlag();
+
+        if (maxAfpsCount <= afpsId)
+        {
+            throw std::runtime_error("Invalid V-PCC atlas frame parameter set id");
+        }
+
+        m_afpsList[afpsId] = afps;
+    }
+    // Atlas frame order count, from its LSBs and the previous frame. The first, IDR and BLA frames start over.
+    auto getAfoc(std::uint32_t nalType, std::uint32_t afocLsb, const Asps &asps) -> std::int64_t
+    {
+        const auto lsb = static_cast<std::int64_t>(afocLsb);
+
+        if (m_frameList.empty() || ((NAL_BLA_W_LP <= nalType) && (nalType < NAL_CRA)))
+        {
+            m_prevAfoc = lsb;
+            return m_prevAfoc;
+        }
+
+        const auto maxAfocLsb = std::int64_t{1} << asps.log2MaxAfocLsb;
+        const auto prevLsb = m_prevAfoc & (maxAfocLsb - 1);
+        auto msb = m_prevAfoc - prevLsb;
+
+        if ((lsb < prevLsb) && (maxAfocLsb / 2 <= prevLsb - lsb))
+        {
+            msb += maxAfocLsb;
+        }
+        else if ((prevLsb < lsb) && (maxAfocLsb / 2 < lsb - prevLsb))
+        {
+            msb -= maxAfocLsb;
+        }
+
+        m_prevAfoc = msb + lsb;
+
+        return m_prevAfoc;
+    }
+    auto findFrame(const std::function<bool(const AtlasFrame &)> &predicate) const -> const AtlasFrame *
+    {
+        auto iter = std::find_if(m_frameList.rbegin(), m_frameList.rend(), predicate);
+        return (iter != m_frameList.rend()) ? &*iter : nullptr;
+    }
+    auto parseTileHeader(std::uint32_t nalType,
+                         BitReader &reader,
+                         const Asps &asps,
+                         const Afps &afps,
+                         AtlasFrame &frame) -> TileHeader
+    {
+        TileHeader header;
+
+        // ath_id
+        reader.read(afps.tileIdLength);
+        header.type = reader.readUe();
+
+        if (afps.outputFlagPresent)
+        {
+            // ath_atlas_output_flag
+            reader.readFlag();
+        }
+
+        frame.afoc = getAfoc(nalType, reader.read(asps.log2MaxAfocLsb), asps);
+
+        RefListStruct tileRefList;
+        const RefListStruct *refList = &tileRefList;
+
+        if (!asps.refListList.empty() && reader.readFlag())
+        {
+            const auto refListIdx = (1 < asps.refListList.size())
+                                        ? reader.read(ceilLog2(static_cast<std::uint32_t>(asps.refListList.size())))
+                                        : 0U;
+
+            if (asps.refListList.size() <= refListIdx)
+            {
+                throw std::runtime_error("Invalid V-PCC reference list index");
+            }
+
+            refList = &asps.refListList[refListIdx];
+        }
+        else
+        {
+            tileRefList = parseRefListStruct(reader, asps);
+        }
+
+        // Reference frames, the additional AFOC LSBs of long-term entries being ignored
+        const auto maxAfocLsb = std::int64_t{1} << asps.log2MaxAfocLsb;
+        auto afoc = frame.afoc;
+
+        for (const auto &entry : refList->entryList)
+        {
+            if (entry.shortTerm)
+            {
+                afoc -= entry.deltaAfoc;
+                header.refFrameList.push_back(findFrame([=](const auto &ref) { return ref.afoc == afoc; }));
+            }
+            else
+            {
+                // ath_additional_afoc_lsb_present_flag, ath_additional_afoc_lsb_val
+                if (reader.readFlag())
+                {
+                    reader.read(afps.additionalLtAfocLsbLength);
+                }
+
+                header.refFrameList.push_back(findFrame([&](const auto &ref)
+                                                        { return (ref.afoc & (maxAfocLsb - 1)) == entry.afocLsb; }));
+            }
+        }
+
+        const std::int64_t blockSize = std::int64_t{1} << asps.log2PatchPackingBlockSize;
+
+        header.patchSizeXQuantizer = blockSize;
+        header.patchSizeYQuantizer = blockSize;
+        // Inferred as Max(0, asps_geometry_3d_bit_depth_minus1 - asps_geometry_2d_bit_depth_minus1) - 1, plus one
+        header.raw3dOffsetBitCount = (asps.geometry2dBitDepthMinus1 < asps.geometry3dBitDepthMinus1)
+                                         ? asps.geometry3dBitDepthMinus1 - asps.geometry2dBitDepthMinus1
+                                         : 0U;
+
+        if (header.type != SKIP_TILE)
+        {
+            if (asps.normalAxisLimitsQuantization)
+            {
+                header.posMinDQuantizer = reader.read(5);
+
+                if (asps.normalAxisMaxDeltaValue)
+                {
+                    header.posDeltaMaxDQuantizer = reader.read(5);
+                }
+            }
+
+            if (asps.patchSizeQuantizerPresent)
+            {
+                header.patchSizeXQuantizer = std::int64_t{1} << reader.read(3);
+                header.patchSizeYQuantizer = std::int64_t{1} << reader.read(3);
+            }
+
+            if (afps.raw3dOffsetBitCountExplicitMode)
+            {
+                header.raw3dOffsetBitCount = reader.read(floorLog2(asps.geometry3dBitDepthMinus1 + 1)) + 1;
+            }
+
+            if (header.type == P_TILE)
+            {
+                const auto nbEntry = static_cast<std::uint32_t>(refList->entryList.size());
+
+                header.numRefIdxActive = std::min(nbEntry, afps.numRefIdxDefaultActiveMinus1 + 1);
+
+                // ath_num_ref_idx_active_override_flag, ath_num_ref_idx_active_minus1
+                if ((1 < nbEntry) && reader.readFlag())
+                {
+                    header.numRefIdxActive = reader.readUe() + 1;
+                }
+            }
+        }
+
+        reader.alignByte();
+
+        return header;
+    }
+    static void skipPlrData(BitReader &reader, const Asps &asps, const Patch &patch)
+    {
+        const auto blockSize = std::int64_t{1} << asps.log2PatchPackingBlockSize;
+        const auto blockCount =
+            ((patch.sizeX + blockSize - 1) / blockSize) * ((patch.sizeY + blockSize - 1) / blockSize);
+
+        for (const auto &plrMap : asps.plrMapList)
+        {
+            if (!plrMap.present)
+            {
+                continue;
+            }
+
+            const auto modeBitCount = ceilLog2(plrMap.nbModeMinus1 + 1);
+
+            // plrd_level
+            if ((blockCount <= plrMap.blockThresholdPerPatchMinus1 + std::int64_t{1}) || reader.readFlag())
+            {
+                // plrd_present_flag, plrd_mode_minus1
+                if (reader.readFlag())
+                {
+                    reader.read(modeBitCount);
+                }
+            }
+            else
+            {
+                for (std::int64_t i = 0; i < blockCount; i++)
+                {
+                    // plrd_present_block_flag, plrd_block_mode_minus1
+                    if (reader.readFlag())
+                    {
+                        reader.read(modeBitCount);
+                    }
+                }
+            }
+        }
+    }
+    auto parsePatchDataUnit(BitReader &reader, const Asps &asps, const Afps &afps, const TileHeader &header) const
+        -> Patch
+    {
+        Patch patch;
+
+        const auto geometry3dBitCount = asps.geometry3dBitDepthMinus1 + 1;
+
+        patch.posX = reader.readUe();
+        patch.posY = reader.readUe();
+        patch.sizeX = reader.readUe() * header.patchSizeXQuantizer + 1;
+        patch.sizeY = reader.readUe() * header.patchSizeYQuantizer + 1;
+        patch.offsetU = reader.read(geometry3dBitCount);
+        patch.offsetV = reader.read(geometry3dBitCount);
+        patch.offsetD = static_cast<std::int64_t>(reader.read(geometry3dBitCount -
+                                                              std::min(geometry3dBitCount, header.posMinDQuantizer)))
+                        << header.posMinDQuantizer;
+
+        if (asps.normalAxisMaxDeltaValue)
+        {
+            // pdu_3d_range_d
+            const auto bitCount = std::min(asps.geometry2dBitDepthMinus1, asps.geometry3dBitDepthMinus1) + 1;
+            reader.read(bitCount - std::min(bitCount, header.posDeltaMaxDQuantizer));
+        }
+
+        patch.projectionId = reader.read(asps.extendedProjection ? ceilLog2(asps.maxNbProjectionMinus1 + 1) : 3);
+        patch.orientation = reader.read(asps.useEightOrientations ? 3 : 1);
+
+        // pdu_lod_enabled_flag, pdu_lod_scale_x_minus1, pdu_lod_scale_y_idc
+        if (afps.lodMode && reader.readFlag())
+        {
+            reader.readUe();
+            reader.readUe();
+        }
+
+        if (asps.plr)
+        {
+            skipPlrData(reader, asps, patch);
+        }
+
+        return patch;
+    }
+    static void readPatch2dDelta(BitReader &reader, const TileHeader &header, Patch &patch)
+    {
+        patch.posX += reader.readSe();
+        patch.posY += reader.readSe();
+        patch.sizeX += reader.readSe() * header.patchSizeXQuantizer;
+        patch.sizeY += reader.readSe() * header.patchSizeYQuantizer;
+    }
+    static void readPatch3dDelta(BitReader &reader, const Asps &asps, const TileHeader &header, Patch &patch)
+    {
+        patch.offsetU += reader.readSe();
+        patch.offsetV += reader.readSe();
+        patch.offsetD += reader.readSe() * (std::int64_t{1} << header.posMinDQuantizer);
+
+        if (asps.normalAxisMaxDeltaValue)
+        {
+            // ipdu_3d_range_d / mpdu_3d_range_d
+            reader.readSe();
+        }
+    }
+    auto parseInterPatchDataUnit(BitReader &reader,
+                                 const Asps &asps,
+                                 const TileHeader &header,
+                                 std::int64_t &predPatchIdx) const -> Patch
+    {
+        const auto refIdx = (1 < header.numRefIdxActive) ? reader.readUe() : 0U;
+        const auto refPatchIdx = predPatchIdx + reader.readSe();
+
+        predPatchIdx = refPatchIdx + 1;
+
+        auto patch = getRefPatch(header.getRefFrame(refIdx), refPatchIdx);
+
+        readPatch2dDelta(reader, header, patch);
+        readPatch3dDelta(reader, asps, header, patch);
+
+        if (asps.plr)
+        {
+            skipPlrData(reader, asps, patch);
+        }
+
+        return patch;
+    }
+    auto parseMergePatchDataUnit(BitReader &reader, const Asps &asps, const TileHeader &header, std::size_t patchIdx)
+        const -> Patch
+    {
+        const auto refIdx = (1 < header.numRefIdxActive) ? reader.readUe() : 0U;
+
+        auto patch = getRefPatch(header.getRefFrame(refIdx), static_cast<std::int64_t>(patchIdx));
+
+        // mpdu_override_2d_params_flag, mpdu_override_3d_params_flag, mpdu_override_plr_flag
+        if (reader.readFlag())
+        {
+            readPatch2dDelta(reader, header, patch);
+
+            if (asps.plr)
+            {
+                skipPlrData(reader, asps, patch);
+            }
+        }
+        else if (reader.readFlag())
+        {
+            readPatch3dDelta(reader, asps, header, patch);
+
+            if (asps.plr && reader.readFlag())
+            {
+                skipPlrData(reader, asps, patch);
+            }
+        }
+
+        return patch;
+    }
+    // Raw and EOM patches carry points outside of the projected patches, they are read past
+    static void skipRawPatchDataUnit(BitReader &reader, const Afps &afps, const TileHeader &header)
+    {
+        if (0 < afps.auxiliaryTileHeight)
+        {
+            // rpdu_patch_in_auxiliary_video_flag
+            reader.readFlag();
+        }
+
+        // rpdu_2d_pos_x, rpdu_2d_pos_y, rpdu_2d_size_x_minus1, rpdu_2d_size_y_minus1
+        for (int i = 0; i < 4; i++)
+        {
+            reader.readUe();
+        }
+
+        // rpdu_3d_offset_u, rpdu_3d_offset_v, rpdu_3d_offset_d
+        reader.read(3 * header.raw3dOffsetBitCount);
+        // rpdu_points_minus1
+        reader.readUe();
+    }
+    static void skipEomPatchDataUnit(BitReader &reader, const Afps &afps)
+    {
+        if (0 < afps.auxiliaryTileHeight)
+        {
+            // epdu_patch_in_auxiliary_video_flag
+            reader.readFlag();
+        }
+
+        // epdu_2d_pos_x, epdu_2d_pos_y, epdu_2d_size_x_minus1, epdu_2d_size_y_minus1
+        for (int i = 0; i < 4; i++)
+        {
+            reader.readUe();
+        }
+
+        // epdu_associated_patch_idx, epdu_points
+        for (auto nbPatch = std::uint64_t{reader.readUe()} + 1; 0 < nbPatch; nbPatch--)
+        {
+            reader.readUe();
+            reader.readUe();
+        }
+    }
+    void parseTileLayer(std::uint32_t nalType, BitReader &reader)
+    {
+        // atlas_tile_header()
+        if ((NAL_BLA_W_LP <= nalType) && (nalType <= NAL_RSV_IRAP_ACL_29))
+        {
+            // ath_no_output_of_prior_atlas_frames_flag
+            reader.readFlag();
+        }
+
+        const auto &afps = getAfps(reader.readUe());
+        const auto aspsPtr = getAsps(afps.aspsId);
+        const auto &asps = *aspsPtr;
+
+        // ath_atlas_adaptation_parameter_set_id
+        reader.readUe();
+
+        AtlasFrame frame;
+        auto header = parseTileHeader(nalType, reader, asps, afps, frame);
+
+        // atlas_tile_data_unit()
+        if (header.type == SKIP_TILE)
+        {
+            frame.patchList = header.getRefFrame(0).patchList;
+        }
+        else if ((header.type == I_TILE) || (header.type == P_TILE))
+        {
+            const auto intra = header.type == I_TILE;
+            std::int64_t predPatchIdx = 0;
+
+            const std::uint32_t endMode = intra ? std::uint32_t{I_END} : std::uint32_t{P_END};
+
+            for (auto patchMode = reader.readUe(); patchMode != endMode; patchMode = reader.readUe())
+            {
+                if ((intra && (patchMode == I_INTRA)) || (!intra && (patchMode == P_INTRA)))
+                {
+                    frame.patchList.push_back(parsePatchDataUnit(reader, asps, afps, header));
+                }
+                else if ((intra && (patchMode == I_RAW)) || (!intra && (patchMode == P_RAW)))
+                {
+                    skipRawPatchDataUnit(reader, afps, header);
+                }
+                else if ((intra && (patchMode == I_EOM)) || (!intra && (patchMode == P_EOM)))
+                {
+                    skipEomPatchDataUnit(reader, afps);
+                }
+                else if (!intra && (patchMode == P_INTER))
+                {
+                    frame.patchList.push_back(parseInterPatchDataUnit(reader, asps, header, predPatchIdx));
+                }
+                else if (!intra && (patchMode == P_MERGE))
+                {
+                    frame.patchList.push_back(parseMergePatchDataUnit(reader, asps, header, frame.patchList.size()));
+                }
+                else if (!intra && (patchMode == P_SKIP))
+                {
+                    frame.patchList.push_back(getRefPatch(header.getRefFrame(0), predPatchIdx++));
+                }
+                else
+                {
+                    throw std::runtime_error("Invalid V-PCC patch mode");
+                }
+            }
+        }
+        else
+        {
+            throw std::runtime_error("Invalid V-PCC atlas tile type");
+        }
+
+        if (vpccMaxPatchCount < frame.patchList.size())
+        {
+            throw std::runtime_error("Too many patches in a V-PCC atlas frame");
+        }
+
+        if (!frame.patchList.empty())
+        {
+            m_pendingList.push_back({aspsPtr, frame.patchList});
+        }
+
+        // Only the frames the decoded atlas frame buffer may hold are kept as references
+        m_frameList.push_back(std::move(frame));
+
+        while (asps.maxDecAtlasFrameBufferingMinus1 + std::size_t{1} < m_frameList.size())
+        {
+            m_frameList.pop_front();
+        }
+    }
+    static auto toMetadata(const std::vector<Patch> &patchList, const Asps &asps, int frameIndex) -> VpccMetadata
+    {
+        VpccMetadata metadata;
+
+        metadata.frame_index = frameIndex;
+        metadata.frame_width = static_cast<int>(asps.frameWidth);
+        metadata.frame_height = static_cast<int>(asps.frameHeight);
+
+        const auto blockSize = std::int64_t{1} << asps.log2PatchPackingBlockSize;
+        const auto mapWidth = static_cast<std::int64_t>(asps.frameWidth) / blockSize;
+        const auto mapHeight = static_cast<std::int64_t>(asps.frameHeight) / blockSize;
+        const auto maxDepth = std::int64_t{1} << (asps.geometry3dBitDepthMinus1 + 1);
+
+        metadata.patch_count = static_cast<int>(patchList.size());
+        metadata.blockToPatch.assign(static_cast<std::size_t>(mapWidth * mapHeight), 0);
+        metadata.patchBlockBuffers.reserve(getVpccPatchTableSize(patchList.size()));
+
+        for (const auto &patch : patchList)
+        {
+            const auto projectionMode = (patch.projectionId % 6) < 3 ? 0 : 1;
 
-void exportToFile(std::string /*path*/, uint8_t * /*data*/, size_t /*size*/)
+            VpccPatchMetadata m;
+            m.U0 = static_cast<std::uint16_t>(patch.posX);
+            m.V0 = static_cast<std::uint16_t>(patch.posY);
+            m.U1 = static_cast<std::uint16_t>(patch.offsetU);
+            m.V1 = static_cast<std::uint16_t>(patch.offsetV);
+            // Far projections are offset from the maximum depth
+            m.D1 = static_cast<std::uint16_t>((projectionMode == 0) ? patch.offsetD : maxDepth - patch.offsetD);
+            m.NormalAxis = static_cast<std::uint16_t>(patch.projectionId % 3);
+            m.PatchOrientation = static_cast<std::uint16_t>(patch.orientation);
+            m.ProjectionMode = static_cast<std::uint16_t>(projectionMode);
+            metadata.patchBlockBuffers.push_back(m);
+        }
+
+        metadata.patchBlockBuffers.resize(getVpccPatchTableSize(patchList.size()));
+
+        // Block-to-patch map [9.2.6]: each patch covers its rectangle of blocks, rotated by its orientation, and the
+        // patch index plus one is written over those of the patches it takes precedence over
+        const auto nbPatch = patchList.size();
+
+        for (std::size_t i = 0; i < nbPatch; i++)
+        {
+            const auto patchIdx = asps.patchPrecedenceOrder ? nbPatch - 1 - i : i;
+            const auto &patch = patchList[patchIdx];
+
+            const auto sizeU0 = (patch.sizeX + blockSize - 1) / blockSize;
+            const auto sizeV0 = (patch.sizeY + blockSize - 1) / blockSize;
+            // FPO_SWAP, FPO_ROT90, FPO_ROT270 and FPO_MROT90 exchange the patch width and height
+            const auto swapped = (patch.orientation == 1) || (patch.orientation == 2) || (patch.orientation == 4) ||
+                                 (patch.orientation == 6);
+
+            const auto x0 = std::clamp<std::int64_t>(patch.posX, 0, mapWidth);
+            const auto y0 = std::clamp<std::int64_t>(patch.posY, 0, mapHeight);
+            const auto x1 = std::clamp<std::int64_t>(patch.posX + (swapped ? sizeV0 : sizeU0), 0, mapWidth);
+            const auto y1 = std::clamp<std::int64_t>(patch.posY + (swapped ? sizeU0 : sizeV0), 0, mapHeight);
+
+            for (auto y = y0; y < y1; y++)
+            {
+                std::fill(metadata.blockToPatch.begin() + y * mapWidth + x0,
+                          metadata.blockToPatch.begin() + y * mapWidth + x1,
+                          static_cast<std::uint16_t>(patchIdx + 1));
+            }
+        }
+
+        return metadata;
+    }
+};
+} // namespace
+
+auto parse(ByteSpan inputData, unsigned nbThread) -> Segment
 {
-    //TODO
-}
+    Segment segment;
+    AtlasParser atlasParser;
+    std::optional<std::uint32_t> atlasId;
 
+    const auto unitList = splitSampleStream(inputData);
 
-auto getVpccVideoStreamName(int videoStreamId) -> const std::string &
+    // First atlas, as found in the first atlas data unit
+    for (const auto &unit : unitList)
+    {
+        if ((4 <= unit.size()) && ((unit[0] >> 3U) == V3C_AD))
+        {
+            atlasId = static_cast<std::uint32_t>(unit[1] >> 1U) & 0x3FU;
+            break;
+        }
+    }
+
+    if (!atlasId)
+    {
+        throw std::runtime_error("V-PCC segment without atlas data");
+    }
+
+    auto otherAtlas = false;
+
+    for (const auto &unit : unitList)
+    {
+        if (unit.size() < 4)
+        {
+            continue;
+        }
+
+        // vuh_unit_type u(5), vuh_v3c_parameter_set_id u(4), vuh_atlas_id u(6), then type specific fields
+        const auto vuh = (static_cast<std::uint32_t>(unit[0]) << 24U) | (static_cast<std::uint32_t>(unit[1]) << 16U) |
+                         (static_cast<std::uint32_t>(unit[2]) << 8U) | unit[3];
+        const auto unitType = vuh >> 27U;
+        const auto payload = unit.subspan(4, unit.size() - 4);
+
+        if ((unitType == V3C_VPS) || (V3C_CAD <= unitType))
+        {
+            continue;
+        }
+
+        if (((vuh >> 17U) & 0x3FU) != *atlasId)
+        {
+            otherAtlas = true;
+            continue;
+        }
+
+        switch (unitType)
+        {
+            case V3C_AD:
+                atlasParser.parse(payload);
+                break;
+            case V3C_OVD:
+                segment.videoUnitList[VideoStream::Occupancy].push_back(payload);
+                break;
+            case V3C_GVD:
+                // vuh_map_index u(4), vuh_auxiliary_video_flag u(1): first map, out of the auxiliary video
+                if (((vuh >> 12U) & 0x1FU) == 0)
+                {
+                    segment.videoUnitList[VideoStream::Geometry].push_back(payload);
+                }
+                break;
+            case V3C_AVD:
+                // vuh_attribute_index u(7), vuh_attribute_partition_index u(5), vuh_map_index u(4),
+                // vuh_auxiliary_video_flag u(1): first partition of the first attribute (texture), as above
+                if ((vuh & 0x1FFFFU) == 0)
+                {
+                    segment.videoUnitList[VideoStream::Texture].push_back(payload);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (otherAtlas)
+    {
+        LOG_WARNING("Only the first atlas of V-PCC content is decoded");
+    }
+
+    segment.frameList = atlasParser.takeMetadataList(nbThread);
+
+    return segment;
+}
+
+auto toAnnexB(const VideoUnitList &videoUnitList) -> Descriptor::Data::container_type
 {
-    static std::array<std::string, VideoStream::Size> videoStreamNameList = {
-        "Occupancy", "Geometry", "Texture", "Transparency"};
+    std::size_t size = 0;
 
-    return videoStreamNameList[videoStreamId];
+    for (const auto &payload : videoUnitList)
+    {
+        size += payload.size();
+    }
+
+    Descriptor::Data::container_type outputData(size);
+    auto *dst = outputData.data();
+
+    // Each 4-byte NAL unit size is replaced by a 4-byte start code
+    for (const auto &payload : videoUnitList)
+    {
+        for (std::size_t pos = 0; pos < payload.size();)
+        {
+            if (payload.size() - pos < 4)
+            {
+                LOG_ERROR("Truncated NAL unit size");
+                return {};
+            }
+
+            const auto nalSize = (static_cast<std::size_t>(payload[pos]) << 24U) |
+                                 (static_cast<std::size_t>(payload[pos + 1]) << 16U) |
+                                 (static_cast<std::size_t>(payload[pos + 2]) << 8U) | payload[pos + 3];
+
+            if (payload.size() - pos - 4 < nalSize)
+            {
+                LOG_ERROR("Truncated NAL unit");
+                return {};
+            }
+
+            dst[0] = 0;
+            dst[1] = 0;
+            dst[2] = 0;
+            dst[3] = 1;
+            std::memcpy(dst + 4, payload.data() + pos + 4, nalSize);
+
+            dst += 4 + nalSize;
+            pos += 4 + nalSize;
+        }
+    }
+
+    return outputData;
 }
+} // namespace vpcc
+
+#if defined TMC2_VPCC_PARSER
+namespace
+{
+using namespace pcc;
 
-auto decodeVpccBuffer(std::vector<uint8_t> &inputData)
+// Reference parser, going through a full TMC2 decoding context
+auto decodeTmc2Buffer(std::vector<uint8_t> &inputData, unsigned nbThread)
     -> std::pair<std::vector<VpccMetadata>, std::array<DataPacket, VideoStream::Size>>
 {
     std::vector<VpccMetadata> framesMetadata;
@@ -116,17 +1304,32 @@ auto decodeVpccBuffer(std::vector<uint8_t> &inputData)
     //const uint16_t blockAttributeSize = sizeof(int16_t);
     //const uint16_t blockAttributes = 9;
 
-    int frame_index = 0;
+    // Frames with patches, their metadata being extracted independently once the atlas is decoded
+    std::vector<std::remove_reference_t<decltype(context.getFrames()[0])> *> frameList;
 
     for (auto &frame : context.getFrames())
     {
         const size_t numPatches = frame.getTile(0).getPatches().size();
 
-        std::vector<VpccPatchMetadata> framePatchMetadataList;
-        //uint16_t activeBlocks = 0;
-        std::vector<size_t> blockToPatch;
-        if (numPatches > 0)
+        if (vpccMaxPatchCount < numPatches)
+        {
+            LOG_ERROR("V-PCC frame #", frameList.size(), " has too many patches, skipped");
+        }
+        else if (numPatches > 0)
+        {
+            frameList.push_back(&frame);
+        }
+    }
+
+    framesMetadata.resize(frameList.size());
+
+    vpcc::runFrameTasks(
+        frameList.size(),
+        [&](std::size_t frame_index)
         {
+            auto &frame = *frameList[frame_index];
+            const size_t numPatches = frame.getTile(0).getPatches().size();
+
             // TODO : assumes same occupancy resolution for all patches in frame
             // we should be able to manage per patch occupancy resolution ?
             const size_t &occupancyResolution = frame.getTile(0).getPatches()[0].getOccupancyResolution();
@@ -134,7 +1337,7 @@ auto decodeVpccBuffer(std::vector<uint8_t> &inputData)
             const size_t blockToPatchHeight = frame.getTile(0).getHeight() / occupancyResolution;
             const size_t blockCount = blockToPatchWidth * blockToPatchHeight;
 
-            blockToPatch.resize(blockCount, 0);
+            std::vector<std::uint16_t> blockToPatch(blockCount, 0);
 
             for (size_t patchIdx = 0; patchIdx < numPatches; ++patchIdx)
             {
@@ -152,20 +1355,18 @@ auto decodeVpccBuffer(std::vector<uint8_t> &inputData)
                     {
                         const int32_t blockIndex =
                             patch.patchBlock2CanvasBlock(u0, v0, blockToPatchWidth, blockToPatchHeight);
-                        blockToPatch[blockIndex] = patchIdx + 1;
+                        blockToPatch[blockIndex] = static_cast<std::uint16_t>(patchIdx + 1);
                     }
                 }
             }
 
-            // MetadataToTexture(frameGroup, frame, blockToPatch, blockToPatchWidth, blockToPatchHeight);
-
-            framePatchMetadataList.reserve(sizeof(VpccPatchMetadata) * numPatches);
+            std::vector<VpccPatchMetadata> framePatchMetadataList;
+            framePatchMetadataList.reserve(getVpccPatchTableSize(numPatches));
 
             for (size_t patchIdx = 0; patchIdx < numPatches; ++patchIdx)
             {
                 const auto &patch = frame.getTile(0).getPatches()[patchIdx];
                 VpccPatchMetadata m;
-                //m.frame_index= frame_index; // was 0, is probably reserved
                 m.U0 = patch.getU0();
                 m.V0 = patch.getV0();
                 m.U1 = patch.getU1();
@@ -177,21 +1378,18 @@ auto decodeVpccBuffer(std::vector<uint8_t> &inputData)
                 framePatchMetadataList.push_back(std::move(m));
             }
 
-            VpccMetadata metadata;
-            metadata.frame_index = frame_index;
+            framePatchMetadataList.resize(getVpccPatchTableSize(numPatches));
+
+            auto &metadata = framesMetadata[frame_index];
+            metadata.frame_index = static_cast<int>(frame_index);
             metadata.frame_height = frame.getTile(0).getHeight();
             metadata.frame_width = frame.getTile(0).getWidth();
+            metadata.patch_count = static_cast<int>(numPatches);
 
             metadata.blockToPatch = std::move(blockToPatch);
             metadata.patchBlockBuffers = std::move(framePatchMetadataList);
-            framesMetadata.push_back(std::move(metadata));
-            frame_index++;
-        }
-
-      /*  metadata.blockToPatch.push_back(std::move(blockToPatch));
-        metadata.patchBlockBuffers.push_back(std::move(framePatchMetadataList));*/
-        //metadata.patchBlockSizes.push_back(activeBlocks);
-    }
+        },
+        nbThread);
 
     LOG_DEBUG("V-PCC parsing Done.");
 
@@ -201,5 +1399,55 @@ auto decodeVpccBuffer(std::vector<uint8_t> &inputData)
              std::move(textureDataPacket),
              std::move(transparencyDataPacket)}}; //Null
 }
+} // namespace
+
+auto decodeVpccBuffer(ByteSpan inputData, unsigned nbThread)
+    -> std::pair<std::vector<VpccMetadata>, std::array<DataPacket, VideoStream::Size>>
+{
+    std::vector<uint8_t> buffer{inputData.begin(), inputData.end()};
+    return decodeTmc2Buffer(buffer, nbThread);
+}
+#else
+auto decodeVpccBuffer(ByteSpan inputData, unsigned nbThread)
+    -> std::pair<std::vector<VpccMetadata>, std::array<DataPacket, VideoStream::Size>>
+{
+    vpcc::Segment segment;
+
+    try
+    {
+        segment = vpcc::parse(inputData, nbThread);
+    }
+    catch (const std::runtime_error &e)
+    {
+        LOG_ERROR(e.what());
+        return {};
+    }
+
+    std::array<DataPacket, VideoStream::Size> videoDataPacketList;
+
+    for (std::size_t videoStreamId = 0; videoStreamId < VideoStream::Size; videoStreamId++)
+    {
+        const auto &videoUnitList = segment.videoUnitList[videoStreamId];
+
+        if (videoUnitList.empty())
+        {
+            continue;
+        }
+
+        auto data = vpcc::toAnnexB(videoUnitList);
 
+        if (!data.empty())
+        {
+            videoDataPacketList[videoStreamId] = make_packet<Descriptor::Data>(std::move(data));
+        }
+        else
+        {
+            LOG_ERROR("Invalid ", getVpccVideoStreamName(static_cast<int>(videoStreamId)), " data");
+        }
+    }
+
+    LOG_DEBUG("V-PCC parsing Done.");
 
+    return {std::move(segment.frameList), std::move(videoDataPacketList)};
+}
+#endif
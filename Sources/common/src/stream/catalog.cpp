@@ -0,0 +1,74 @@
+/*
+* Copyright (c) 2025 InterDigital CE Patent Holdings SASU
+* Licensed under the License terms of 5GMAG software (the "License").
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at https://www.5g-mag.com/license .
+* Unless required by applicable law or agreed to in writing, software distributed under the License is
+* distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and limitations under the License.
+*/
+
+#include <common/stream/catalog.h>
+#include <iloj/misc/filesystem.h>
+
+using namespace iloj::misc;
+
+auto Catalog::getItem(std::size_t itemId) const -> const Item &
+{
+    auto &slot = *m_itemList[itemId];
+
+    // Left unset if building throws, the next request trying again
+    std::call_once(slot.flag,
+                   [this, &slot, itemId]()
+                   { slot.item = std::make_unique<const Item>(m_library, static_cast<int>(itemId), true); });
+
+    return *slot.item;
+}
+
+auto Catalog::fromConfig(const std::string &configFile) -> std::shared_ptr<const Catalog>
+{
+    auto json = JSON::Object::fromFile(configFile);
+
+    const auto libraryPath = FileSystem::Path::getAbsolute(
+        {json.getItem<JSON::String>("Library").getValue(), FileSystem::Path{configFile}.getParent()});
+    if (!FileSystem::File{libraryPath}.exist())
+    {
+        LOG_ERROR("Library file not found: ", libraryPath.toString());
+        return {};
+    }
+
+    std::shared_ptr<Catalog> catalog{new Catalog{}};
+
+    catalog->m_library = JSON::Object::fromFile(libraryPath.toString());
+    if (catalog->m_library.isEmpty())
+    {
+        LOG_ERROR("Library is unreadable");
+        return {};
+    }
+
+    catalog->m_library.setItem<JSON::String>("BaseDirectory", libraryPath.getParent().toString());
+
+    const auto &jsonPlaylist = catalog->m_library.getItem<JSON::Array>("Playlist");
+    const auto nbChannel = jsonPlaylist.getSize();
+    if (!nbChannel)
+    {
+        LOG_ERROR("Playlist data is either missing or empty");
+        return {};
+    }
+
+    for (std::size_t channelId = 0; channelId < nbChannel; channelId++)
+    {
+        const auto &jsonItem = jsonPlaylist.getItem<JSON::Object>(channelId);
+
+        catalog->m_nameList.push_back(Item::readName(jsonItem, static_cast<int>(channelId)));
+        catalog->m_modeList.push_back(Item::readMode(jsonItem));
+    }
+
+    for (std::size_t channelId = 0; channelId < nbChannel; channelId++)
+    {
+        catalog->m_itemList.push_back(std::make_unique<ItemSlot>());
+    }
+
+    return catalog;
+}
@@ -10,10 +10,15 @@
 */
 
 #include <common/decoder/miv.h>
+#include <common/decoder/package.h>
 #include <common/decoder/vpcc.h>
 #include <common/stream/item.h>
+#include <common/stream/mapped_file.h>
+#include <common/stream/segment_index.h>
 #include <iloj/media/avcodec.h>
 #include <iloj/misc/filesystem.h>
+#include <iloj/misc/thread.h>
+#include <limits>
 
 using namespace iloj::misc;
 using namespace iloj::media;
@@ -74,11 +79,22 @@ auto getSegmentProperty(int typeId, const std::string &path) -> std::pair<double
             AVCodec::Decoder decoder;
             auto inputData = FileSystem::File{path}.toBuffer();
 
-            auto [mivPkt, videoDataPacketList] =
-                miv::decodeMivBuffer({reinterpret_cast<const char *>(inputData.data()), inputData.size()});
-            auto frameRate = static_cast<double>(mivPkt.vui->vui_time_scale()) / mivPkt.vui->vui_num_units_in_tick();
+            if (package::isPackage(inputData.data(), inputData.size()))
+            {
+                return package::readProperty(inputData.data(), inputData.size());
+            }
 
-            decoder.getStreamingInput().push(videoDataPacketList[VideoStream::Texture]);
+            auto [mivPkt, atlasDataPacketList] = miv::decodeMivBuffer({inputData.data(), inputData.size()});
+
+            if (atlasDataPacketList.empty())
+            {
+                return {};
+            }
+
+            auto frameRate = static_cast<double>(mivPkt->vui->vui_time_scale()) / mivPkt->vui->vui_num_units_in_tick();
+
+            // All the atlases share the frame count
+            decoder.getStreamingInput().push(atlasDataPacketList.front()[VideoStream::Texture]);
             decoder.getStreamingInput().push(Packet<Descriptor::Data>{});
 
             decoder.open("", { AVCodec::Decoder::Stream::BestVideo});
@@ -92,7 +108,12 @@ auto getSegmentProperty(int typeId, const std::string &path) -> std::pair<double
             AVCodec::Decoder decoder;
             auto inputData = FileSystem::File{path}.toBuffer();
 
-            auto [mivPkt, videoDataPacketList] = decodeVpccBuffer(inputData);
+            if (package::isPackage(inputData.data(), inputData.size()))
+            {
+                return package::readProperty(inputData.data(), inputData.size());
+            }
+
+            auto [mivPkt, videoDataPacketList] = decodeVpccBuffer({inputData.data(), inputData.size()});
 
             auto frameRate = 30.0;
             // static_cast<double>(mivPkt->vui->vui_time_scale()) / mivPkt->vui->vui_num_units_in_tick();
@@ -116,34 +137,101 @@ auto getSegmentProperty(int typeId, const std::string &path) -> std::pair<double
     }
 }
 
-} // namespace
-
-Item::Item(JSON::Object &config, int itemId, bool buildIndex)
+// Payload already in memory (cache) or mappable, empty if the file has to be read. The stamp of the file is only
+// needed along with a cache.
+auto findSegment(const Chunk::Header &header,
+                 const std::string &path,
+                 const SegmentIndex::Stamp &stamp,
+                 bool memoryMapping,
+                 SegmentCache *cache) -> Chunk
 {
-    auto &jsonDirectory = config.getItem<JSON::String>("BaseDirectory").getValue();
-    auto &jsonItem = config.getItem<JSON::Array>("Playlist").getItem<JSON::Object>(itemId);
-    auto &baseDirectory = jsonItem.getItem<JSON::String>("BaseDirectory").getValue();
-    auto &streamList = jsonItem.getItem<JSON::Array>("StreamList");
-   
-    m_itemId = itemId;
+    if (cache)
+    {
+        if (auto entry = cache->find(path, stamp))
+        {
+            return {header, std::move(entry->storage), entry->data, entry->size};
+        }
+    }
 
-    if (jsonItem.hasItem("Name"))
+    if (memoryMapping)
     {
-        m_name = jsonItem.getItem<JSON::String>("Name").getValue();
+        if (auto mapping = MappedFile::open(path))
+        {
+            SegmentCache::Entry entry{mapping, mapping->data(), mapping->size()};
+
+            if (cache)
+            {
+                cache->insert(path, stamp, entry);
+            }
+
+            return {header, std::move(entry.storage), entry.data, entry.size};
+        }
     }
-    else
+
+    return {};
+}
+
+auto makeSegment(const Chunk::Header &header,
+                 const std::string &path,
+                 const SegmentIndex::Stamp &stamp,
+                 Chunk::Buffer data,
+                 SegmentCache *cache) -> Chunk
+{
+    if (!cache || data.empty())
     {
-        m_name = "NONAME_" + int2str(m_itemId, 3);
+        return {header, std::move(data)};
     }
-    if (jsonItem.hasItem("Mode"))
+
+    // Cached payloads must be shared with the chunks
+    auto buffer = std::make_shared<const Chunk::Buffer>(std::move(data));
+    SegmentCache::Entry entry{buffer, buffer->data(), buffer->size()};
+
+    cache->insert(path, stamp, entry);
+
+    return {header, std::move(entry.storage), entry.data, entry.size};
+}
+
+// Sidecar index of an item, suffixed with a hash of its segment paths (FNV-1a, stable across builds), so that items
+// sharing a name, unnamed ones in particular, do not share a sidecar
+auto getIndexFileName(const std::string &name, const std::vector<Item::Stream> &streamList) -> std::string
+{
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+
+    for (const auto &stream : streamList)
     {
-        m_mode = jsonItem.getItem<JSON::String>("Mode").getValue();
+        for (auto c : stream.getPath())
+        {
+            hash = (hash ^ static_cast<std::uint8_t>(c)) * 0x100000001b3ULL;
+        }
+
+        // Null separator between the paths
+        hash *= 0x100000001b3ULL;
     }
-    else
+
+    static constexpr char digitList[] = "0123456789abcdef";
+    std::string suffix(16, '0');
+
+    for (auto i = 0; i < 16; i++)
     {
-        m_mode = "Local";
+        suffix[15 - i] = digitList[(hash >> (4 * i)) & 0xFU];
     }
-    
+
+    return name + "_" + suffix + ".v3cindex";
+}
+
+} // namespace
+
+Item::Item(JSON::Object &config, int itemId, bool buildIndex)
+{
+    auto &jsonDirectory = config.getItem<JSON::String>("BaseDirectory").getValue();
+    auto &jsonItem = config.getItem<JSON::Array>("Playlist").getItem<JSON::Object>(itemId);
+    auto &baseDirectory = jsonItem.getItem<JSON::String>("BaseDirectory").getValue();
+    auto &streamList = jsonItem.getItem<JSON::Array>("StreamList");
+
+    m_itemId = itemId;
+
+    m_name = readName(jsonItem, itemId);
+    m_mode = readMode(jsonItem);
 
     for (auto streamId = 0ULL; streamId < streamList.getSize(); streamId++)
     {
@@ -183,16 +271,30 @@ Item::Item(JSON::Object &config, int itemId, bool buildIndex)
         // in remote mode (DASH), Duration and NbFrame have no meaning, so skip them.
         if (!to_lower(m_mode).compare("local"))
         {
+            // Segments without explicit properties in the library are looked up in the sidecar index
+            struct Job
+            {
+                std::size_t streamId;
+                std::size_t segmentId;
+                std::string path;
+                SegmentIndex::Stamp stamp;
+            };
+
+            std::vector<Job> staleJobList;
+            SegmentIndex index{FileSystem::Path::getAbsolute({baseDirectory, jsonDirectory}).toString() + "/" +
+                               getIndexFileName(m_name, m_streamList)};
+
             for (std::size_t streamId = 0ULL; streamId < m_streamList.size(); streamId++)
             {
                 auto &stream = streamList.getItem<JSON::Object>(streamOrder[streamId]);
+                const auto &streamElement = m_streamList[streamId];
 
                 if (stream.hasItem("Duration") && stream.hasItem("NbFrame"))
                 {
                     auto &duration = stream.getItem<JSON::Array>("Duration");
                     auto &nbFrame = stream.getItem<JSON::Array>("NbFrame");
 
-                    for (auto segmentId = 0; segmentId < m_streamList[streamId].getNumberOfSegments(); segmentId++)
+                    for (auto segmentId = 0; segmentId < streamElement.getNumberOfSegments(); segmentId++)
                     {
                         m_streamProperty[streamId].emplace_back(std::make_pair(
                             duration.getItem(segmentId).as<double>(), nbFrame.getItem(segmentId).as<std::uint32_t>()));
@@ -200,22 +302,65 @@ Item::Item(JSON::Object &config, int itemId, bool buildIndex)
                 }
                 else
                 {
-                    auto &duration = stream.setItem<JSON::Array>("Duration");
-                    auto &nbFrame = stream.setItem<JSON::Array>("NbFrame");
-
-                    const auto &streamElement = m_streamList[streamId];
+                    m_streamProperty[streamId].resize(streamElement.getNumberOfSegments());
 
-                    for (auto segmentId = 0; segmentId < m_streamList[streamId].getNumberOfSegments(); segmentId++)
+                    for (auto segmentId = 0; segmentId < streamElement.getNumberOfSegments(); segmentId++)
                     {
                         auto path = format(streamElement.getPath().c_str(), segmentId);
-                        auto property = getSegmentProperty(streamElement.getTypeId(), path);
+                        auto stamp = SegmentIndex::getStamp(path);
+
+                        if (const auto *entry = index.find(path, stamp))
+                        {
+                            m_streamProperty[streamId][segmentId] = {entry->duration, entry->nbFrame};
+                        }
+                        else
+                        {
+                            staleJobList.push_back(
+                                {streamId, static_cast<std::size_t>(segmentId), std::move(path), stamp});
+                        }
+                    }
+                }
+            }
+
+            if (!staleJobList.empty())
+            {
+                LOG_INFO("Indexing ", staleJobList.size(), " segment(s) of ", m_name);
+
+                std::vector<std::exception_ptr> errorList(staleJobList.size());
+
+                parallel_for(staleJobList.size(),
+                             [&](std::size_t jobId)
+                             {
+                                 const auto &job = staleJobList[jobId];
+
+                                 try
+                                 {
+                                     m_streamProperty[job.streamId][job.segmentId] =
+                                         getSegmentProperty(m_streamList[job.streamId].getTypeId(), job.path);
+                                 }
+                                 catch (...)
+                                 {
+                                     errorList[jobId] = std::current_exception();
+                                 }
+                             });
+
+                for (std::size_t jobId = 0; jobId < staleJobList.size(); jobId++)
+                {
+                    const auto &job = staleJobList[jobId];
 
-                        duration.setItem<JSON::Float>(segmentId, static_cast<float>(property.first));
-                        nbFrame.setItem<JSON::Integer>(segmentId, static_cast<int>(property.second));
+                    if (errorList[jobId])
+                    {
+                        std::rethrow_exception(errorList[jobId]);
+                    }
 
-                        m_streamProperty[streamId].emplace_back(property);
+                    if (job.stamp.fileSize != 0)
+                    {
+                        const auto &[duration, nbFrame] = m_streamProperty[job.streamId][job.segmentId];
+                        index.update(job.path, {job.stamp, duration, nbFrame});
                     }
                 }
+
+                index.save();
             }
         }
     }
@@ -223,65 +368,166 @@ Item::Item(JSON::Object &config, int itemId, bool buildIndex)
 
 void Item::reset() { std::fill(m_streamState.begin(), m_streamState.end(), State{0, 0.}); }
 
-auto Item::next() -> std::tuple<std::size_t, Chunk, std::chrono::duration<double>>
+auto Item::seek(double position) -> double
 {
-    // Finding best stream to send (the most late)
-    auto iter =
-        std::min_element(m_streamState.begin(),
-                         m_streamState.end(),
-                         [](const auto &s1, const auto &s2) { return (s1.getStreamDelay() < s2.getStreamDelay()); });
+    auto origin = std::numeric_limits<double>::max();
 
-    if (iter->getSegmentId() < 0)
+    for (std::size_t streamId = 0; streamId < m_streamList.size(); streamId++)
     {
-        std::fill(m_streamState.begin(), m_streamState.end(), State{0, 0.});
-        iter = m_streamState.begin();
+        const auto &property = m_streamProperty[streamId];
+        auto nbSegment = std::min<std::size_t>(property.size(), m_streamList[streamId].getNumberOfSegments());
+
+        // Segments are decodable on their own, so their start is the nearest random access point
+        std::size_t segmentId = 0;
+        double start = 0.;
+
+        while ((segmentId + 1 < nbSegment) && (start + property[segmentId].first <= position))
+        {
+            start += property[segmentId].first;
+            segmentId++;
+        }
+
+        m_streamState[streamId] = State{static_cast<int>(segmentId), start};
+        origin = std::min(origin, start);
     }
 
-    auto bestStreamId = static_cast<std::size_t>(std::distance(m_streamState.begin(), iter));
+    return m_streamList.empty() ? 0. : origin;
+}
+
+auto Item::next() -> Segment { return std::move(next(1).front()); }
+
+auto Item::isAtEnd() const -> bool
+{
+    // Same choice as next()
+    auto iter = std::min_element(m_streamState.begin(),
+                                 m_streamState.end(),
+                                 [](const auto &s1, const auto &s2)
+                                 { return (s1.getStreamDelay() < s2.getStreamDelay()); });
+
+    return (iter != m_streamState.end()) && (iter->getSegmentId() < 0);
+}
 
-    const auto &stream = m_streamList[bestStreamId];
-    auto &property = m_streamProperty[bestStreamId];
-    auto &state = m_streamState[bestStreamId];
+auto Item::next(std::size_t nbSegment) -> std::vector<Segment>
+{
+    std::vector<Segment> segmentList;
+    std::vector<Chunk::Header> headerList(nbSegment);
+    std::vector<std::string> pathList;
 
-    // Preparing chunk
-    auto path = format(stream.getPath().c_str(), state.getSegmentId());
-    auto data = FileSystem::File{path}.toBuffer();
+    segmentList.reserve(nbSegment);
+    pathList.reserve(nbSegment);
 
-    if (data.empty())
+    for (std::size_t i = 0; i < nbSegment; i++)
     {
-        LOG_ERROR("Invalid stream file: ", path);
+        // Finding best stream to send (the most late)
+        auto iter = std::min_element(m_streamState.begin(),
+                                     m_streamState.end(),
+                                     [](const auto &s1, const auto &s2)
+                                     { return (s1.getStreamDelay() < s2.getStreamDelay()); });
+
+        if (iter->getSegmentId() < 0)
+        {
+            std::fill(m_streamState.begin(), m_streamState.end(), State{0, 0.});
+            iter = m_streamState.begin();
+        }
+
+        auto bestStreamId = static_cast<std::size_t>(std::distance(m_streamState.begin(), iter));
+
+        const auto &stream = m_streamList[bestStreamId];
+        auto &property = m_streamProperty[bestStreamId];
+        auto &state = m_streamState[bestStreamId];
+
+        auto path = format(stream.getPath().c_str(), state.getSegmentId());
+
+        if (static_cast<int>(property.size()) <= state.getSegmentId())
+        {
+            property.emplace_back(getSegmentProperty(stream.getTypeId(), path));
+        }
+
+        const auto &[duration, nbFrame] = property[state.getSegmentId()];
+
+        // Preparing chunk, the payload is attached once the whole batch is read
+        auto &header = headerList[i];
+
+        header.setTypeId(stream.getTypeId());
+        header.setMediaId(m_itemId);
+        header.setSegmentId(state.getSegmentId());
+        header.setNumberOfFrames(nbFrame);
+
+        segmentList.emplace_back(bestStreamId, Chunk{}, std::chrono::duration<double>{duration});
+        pathList.push_back(std::move(path));
+
+        // Updating state
+        state.update(duration, stream.getNumberOfSegments());
     }
 
-    if (static_cast<int>(property.size()) <= state.getSegmentId())
+    // Filling chunks, cached payloads being checked against their file before being served
+    std::vector<SegmentIO::Request> requestList;
+    std::vector<std::size_t> requestOrder;
+    std::vector<SegmentIndex::Stamp> stampList(nbSegment);
+
+    for (std::size_t i = 0; i < nbSegment; i++)
     {
-        property.emplace_back(getSegmentProperty(stream.getTypeId(), path));
+        auto &chunk = std::get<Chunk>(segmentList[i]);
+
+        if (m_segmentCache)
+        {
+            stampList[i] = SegmentIndex::getStamp(pathList[i]);
+        }
+
+        chunk = findSegment(headerList[i], pathList[i], stampList[i], m_memoryMapping, m_segmentCache.get());
+
+        if (chunk.empty())
+        {
+            requestList.push_back({pathList[i]});
+            requestOrder.push_back(i);
+        }
     }
 
-    const auto &[duration, nbFrame] = property[state.getSegmentId()];
+    if (!requestList.empty())
+    {
+        if (m_segmentIO)
+        {
+            m_segmentIO->read(requestList);
+        }
+        else
+        {
+            SyncSegmentIO{}.read(requestList);
+        }
+    }
 
-    // Filling chunk
-    Chunk::Header header;
+    for (std::size_t k = 0; k < requestList.size(); k++)
+    {
+        auto &request = requestList[k];
+        auto i = requestOrder[k];
+        auto &chunk = std::get<Chunk>(segmentList[i]);
 
-    header.setTypeId(stream.getTypeId());
-    header.setMediaId(m_itemId);
-    header.setSegmentId(state.getSegmentId());
-    header.setNumberOfFrames(nbFrame);
-    header.setDataSize(data.size());
+        chunk = makeSegment(headerList[i], request.path, stampList[i], std::move(request.data), m_segmentCache.get());
 
-    // Updating state    
-    state.update(duration, stream.getNumberOfSegments());
+        if (chunk.empty())
+        {
+            LOG_ERROR("Invalid stream file: ", request.path);
+        }
+    }
 
-    return {bestStreamId, {header, std::move(data)}, std::chrono::duration<double>{duration}};
+    return segmentList;
 }
 
-std::vector<Item> Item::makeItemList(JSON::Object &config, unsigned int nbChannel, bool buildIndex)
+auto Item::readName(const JSON::Object &jsonItem, int itemId) -> std::string
 {
-    std::vector<Item> itemList;
+    if (jsonItem.hasItem("Name"))
+    {
+        return jsonItem.getItem<JSON::String>("Name").getValue();
+    }
 
-    for (std::size_t channelId = 0; channelId < nbChannel; channelId++)
+    return "NONAME_" + int2str(itemId, 3);
+}
+
+auto Item::readMode(const JSON::Object &jsonItem) -> std::string
+{
+    if (jsonItem.hasItem("Mode"))
     {
-        itemList.emplace_back(config, channelId, buildIndex);
+        return jsonItem.getItem<JSON::String>("Mode").getValue();
     }
 
-    return itemList;
+    return "Local";
 }
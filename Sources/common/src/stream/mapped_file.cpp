@@ -0,0 +1,118 @@
+/*
+* Copyright (c) 2025 InterDigital CE Patent Holdings SASU
+* Licensed under the License terms of 5GMAG software (the "License").
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at https://www.5g-mag.com/license .
+* Unless required by applicable law or agreed to in writing, software distributed under the License is
+* distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and limitations under the License.
+*/
+
+#include <common/stream/mapped_file.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+    if (m_data)
+    {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mappingHandle)
+    {
+        CloseHandle(m_mappingHandle);
+    }
+    if (m_fileHandle && m_fileHandle != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(m_fileHandle);
+    }
+#else
+    if (m_data)
+    {
+        munmap(const_cast<std::uint8_t *>(m_data), m_size);
+    }
+#endif
+}
+
+auto MappedFile::open(const std::string &path) -> std::shared_ptr<const MappedFile>
+{
+    std::shared_ptr<MappedFile> file{new MappedFile{}};
+
+#ifdef _WIN32
+    file->m_fileHandle = CreateFileA(path.c_str(),
+                                     GENERIC_READ,
+                                     FILE_SHARE_READ,
+                                     nullptr,
+                                     OPEN_EXISTING,
+                                     FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                                     nullptr);
+    if (file->m_fileHandle == INVALID_HANDLE_VALUE)
+    {
+        return {};
+    }
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file->m_fileHandle, &size) || size.QuadPart == 0)
+    {
+        return {};
+    }
+
+    file->m_mappingHandle = CreateFileMappingA(file->m_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!file->m_mappingHandle)
+    {
+        return {};
+    }
+
+    auto *view = MapViewOfFile(file->m_mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (!view)
+    {
+        return {};
+    }
+
+    file->m_data = static_cast<const std::uint8_t *>(view);
+    file->m_size = static_cast<std::size_t>(size.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return {};
+    }
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        ::close(fd);
+        return {};
+    }
+
+    auto size = static_cast<std::size_t>(st.st_size);
+    void *view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // The mapping keeps its own reference on the file
+    ::close(fd);
+
+    if (view == MAP_FAILED)
+    {
+        return {};
+    }
+
+    // Segments are consumed front to back right after being mapped: ask for aggressive read-ahead so
+    // the parser does not stall on one page fault per page
+    madvise(view, size, MADV_SEQUENTIAL);
+    madvise(view, size, MADV_WILLNEED);
+
+    file->m_data = static_cast<const std::uint8_t *>(view);
+    file->m_size = size;
+#endif
+
+    return file;
+}
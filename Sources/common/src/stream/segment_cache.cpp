@@ -0,0 +1,86 @@
+/*
+* Copyright (c) 2025 InterDigital CE Patent Holdings SASU
+* Licensed under the License terms of 5GMAG software (the "License").
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at https://www.5g-mag.com/license .
+* Unless required by applicable law or agreed to in writing, software distributed under the License is
+* distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and limitations under the License.
+*/
+
+#include <common/stream/segment_cache.h>
+
+auto SegmentCache::getBytes() -> std::size_t
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_bytes;
+}
+
+auto SegmentCache::find(const std::string &path, const SegmentIndex::Stamp &stamp) -> std::optional<Entry>
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto iter = m_entryMap.find(path);
+
+    if (iter == m_entryMap.end())
+    {
+        m_misses++;
+        return std::nullopt;
+    }
+
+    // Replaced on disk since it was cached
+    if (!(iter->second->stamp == stamp))
+    {
+        m_bytes -= iter->second->entry.size;
+        m_list.erase(iter->second);
+        m_entryMap.erase(iter);
+
+        m_misses++;
+        return std::nullopt;
+    }
+
+    m_hits++;
+    m_list.splice(m_list.begin(), m_list, iter->second);
+
+    return iter->second->entry;
+}
+
+void SegmentCache::insert(const std::string &path, const SegmentIndex::Stamp &stamp, Entry entry)
+{
+    if (!entry.storage || m_capacity < entry.size || stamp.fileSize == 0)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (auto iter = m_entryMap.find(path); iter != m_entryMap.end())
+    {
+        m_bytes -= iter->second->entry.size;
+        m_list.erase(iter->second);
+        m_entryMap.erase(iter);
+    }
+
+    while (m_capacity < m_bytes + entry.size)
+    {
+        const auto &last = m_list.back();
+
+        m_bytes -= last.entry.size;
+        m_entryMap.erase(last.path);
+        m_list.pop_back();
+    }
+
+    m_bytes += entry.size;
+    m_list.push_front({path, stamp, std::move(entry)});
+    m_entryMap.emplace(path, m_list.begin());
+}
+
+void SegmentCache::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_entryMap.clear();
+    m_list.clear();
+    m_bytes = 0;
+}
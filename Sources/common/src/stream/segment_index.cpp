@@ -0,0 +1,174 @@
+/*
+* Copyright (c) 2025 InterDigital CE Patent Holdings SASU
+* Licensed under the License terms of 5GMAG software (the "License").
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at https://www.5g-mag.com/license .
+* Unless required by applicable law or agreed to in writing, software distributed under the License is
+* distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and limitations under the License.
+*/
+
+#include <algorithm>
+#include <common/stream/segment_index.h>
+#include <filesystem>
+#include <fstream>
+#include <iloj/misc/logger.h>
+
+namespace
+{
+// Layout (host byte order):
+//   char[4] magic, u32 version, u32 entry count
+//   per entry: u32 path length, path bytes, u64 file size, i64 modification time, f64 duration, u32 frame count
+constexpr char indexMagic[4] = {'V', '3', 'C', 'I'};
+constexpr std::uint32_t indexVersion = 1;
+
+template<typename T>
+void write(std::ostream &os, const T &value)
+{
+    os.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template<typename T>
+auto read(std::istream &is, T &value) -> bool
+{
+    return static_cast<bool>(is.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+} // namespace
+
+SegmentIndex::SegmentIndex(std::string path): m_path{std::move(path)}
+{
+    std::ifstream is{m_path, std::ios::binary};
+
+    if (!is)
+    {
+        return;
+    }
+
+    char magic[4]{};
+    std::uint32_t version{};
+    std::uint32_t nbEntry{};
+
+    if (!is.read(magic, sizeof(magic)) || !std::equal(magic, magic + 4, indexMagic) || !read(is, version) ||
+        version != indexVersion || !read(is, nbEntry))
+    {
+        LOG_WARNING("Ignoring unsupported segment index: ", m_path);
+        return;
+    }
+
+    for (std::uint32_t i = 0; i < nbEntry; i++)
+    {
+        std::uint32_t length{};
+        std::string segmentPath;
+        Entry entry;
+
+        if (!read(is, length))
+        {
+            break;
+        }
+
+        segmentPath.resize(length);
+
+        if (!is.read(segmentPath.data(), length) || !read(is, entry.stamp.fileSize) ||
+            !read(is, entry.stamp.modificationTime) || !read(is, entry.duration) || !read(is, entry.nbFrame))
+        {
+            LOG_WARNING("Truncated segment index: ", m_path);
+            break;
+        }
+
+        m_entryMap.emplace(std::move(segmentPath), entry);
+    }
+}
+
+auto SegmentIndex::find(const std::string &segmentPath, const Stamp &stamp) const -> const Entry *
+{
+    auto iter = m_entryMap.find(segmentPath);
+
+    if (iter != m_entryMap.end() && iter->second.stamp == stamp)
+    {
+        return &iter->second;
+    }
+
+    return nullptr;
+}
+
+void SegmentIndex::update(const std::string &segmentPath, const Entry &entry)
+{
+    m_entryMap[segmentPath] = entry;
+    m_modified = true;
+}
+
+auto SegmentIndex::save() -> bool
+{
+    if (!m_modified)
+    {
+        return true;
+    }
+
+    // Written aside then renamed, so that a concurrent reader never sees a partial index
+    auto tmpPath = m_path + ".tmp";
+
+    {
+        std::ofstream os{tmpPath, std::ios::binary | std::ios::trunc};
+
+        if (!os)
+        {
+            LOG_WARNING("Unable to write segment index: ", m_path);
+            return false;
+        }
+
+        os.write(indexMagic, sizeof(indexMagic));
+        write(os, indexVersion);
+        write(os, static_cast<std::uint32_t>(m_entryMap.size()));
+
+        for (const auto &[segmentPath, entry] : m_entryMap)
+        {
+            write(os, static_cast<std::uint32_t>(segmentPath.size()));
+            os.write(segmentPath.data(), static_cast<std::streamsize>(segmentPath.size()));
+            write(os, entry.stamp.fileSize);
+            write(os, entry.stamp.modificationTime);
+            write(os, entry.duration);
+            write(os, entry.nbFrame);
+        }
+
+        if (!os)
+        {
+            LOG_WARNING("Unable to write segment index: ", m_path);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, m_path, ec);
+
+    if (ec)
+    {
+        LOG_WARNING("Unable to write segment index: ", m_path, " (", ec.message(), ")");
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+
+    m_modified = false;
+
+    return true;
+}
+
+auto SegmentIndex::getStamp(const std::string &segmentPath) -> Stamp
+{
+    std::error_code ec;
+    auto size = std::filesystem::file_size(segmentPath, ec);
+
+    if (ec)
+    {
+        return {};
+    }
+
+    auto time = std::filesystem::last_write_time(segmentPath, ec);
+
+    if (ec)
+    {
+        return {};
+    }
+
+    return {static_cast<std::uint64_t>(size), static_cast<std::int64_t>(time.time_since_epoch().count())};
+}
@@ -0,0 +1,301 @@
+/*
+* Copyright (c) 2025 InterDigital CE Patent Holdings SASU
+* Licensed under the License terms of 5GMAG software (the "License").
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at https://www.5g-mag.com/license .
+* Unless required by applicable law or agreed to in writing, software distributed under the License is
+* distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and limitations under the License.
+*/
+
+#include <common/stream/segment_io.h>
+#include <iloj/misc/filesystem.h>
+#include <iloj/misc/logger.h>
+
+#ifdef IO_URING
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <fcntl.h>
+#include <liburing.h>
+#include <mutex>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace iloj::misc;
+
+void SyncSegmentIO::read(std::vector<Request> &requestList)
+{
+    for (auto &request : requestList)
+    {
+        request.data = FileSystem::File{request.path}.toBuffer();
+        request.valid = !request.data.empty();
+    }
+}
+
+#ifdef IO_URING
+namespace
+{
+// Reads go straight into the segment buffers, which are handed over to the decoder afterwards.
+// Registering them would pin every segment, so only the submission batching is used.
+class UringSegmentIO: public SegmentIO
+{
+private:
+    static constexpr unsigned queueDepth = 32;
+    static constexpr std::size_t maxReadSize = 1U << 30U;
+
+    io_uring m_ring{};
+    bool m_initialized{false};
+    // Cleared for good when the ring fails, reads being synchronous from then on
+    std::atomic<bool> m_ready{false};
+    std::mutex m_mutex;
+    // Tags the completions of each call, in the upper half of their user data
+    std::uint32_t m_generation{};
+    // Buffers of reads the kernel may still complete after the ring failed
+    std::vector<Chunk::Buffer> m_orphanList;
+
+public:
+    UringSegmentIO()
+    {
+        m_initialized = (io_uring_queue_init(queueDepth, &m_ring, 0) == 0);
+        m_ready = m_initialized;
+    }
+    ~UringSegmentIO() override
+    {
+        // Waits for the reads still running, before the orphan buffers go
+        if (m_initialized)
+        {
+            io_uring_queue_exit(&m_ring);
+        }
+    }
+    UringSegmentIO(const UringSegmentIO &) = delete;
+    UringSegmentIO(UringSegmentIO &&) = delete;
+    auto operator=(const UringSegmentIO &) -> UringSegmentIO & = delete;
+    auto operator=(UringSegmentIO &&) -> UringSegmentIO & = delete;
+    auto isReady() const -> bool { return m_ready; }
+    auto getName() const -> std::string override { return "io_uring"; }
+    void read(std::vector<Request> &requestList) override;
+};
+
+void UringSegmentIO::read(std::vector<Request> &requestList)
+{
+    struct Transfer
+    {
+        int fd{-1};
+        std::size_t offset{};
+        bool inFlight{false};
+        bool failed{false};
+    };
+
+    if (!m_ready)
+    {
+        SyncSegmentIO{}.read(requestList);
+        return;
+    }
+
+    std::vector<Transfer> transferList(requestList.size());
+
+    for (std::size_t i = 0; i < requestList.size(); i++)
+    {
+        auto &request = requestList[i];
+        auto &transfer = transferList[i];
+        struct stat info{};
+
+        request.data.clear();
+        request.valid = false;
+
+        transfer.fd = ::open(request.path.c_str(), O_RDONLY | O_CLOEXEC);
+
+        if ((transfer.fd < 0) || (::fstat(transfer.fd, &info) != 0) || (info.st_size <= 0))
+        {
+            transfer.failed = true;
+            continue;
+        }
+
+        request.data.resize(static_cast<std::size_t>(info.st_size));
+    }
+
+    auto isPending = [&](std::size_t i)
+    { return !transferList[i].failed && (transferList[i].offset < requestList[i].data.size()); };
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const std::uint64_t generation = ++m_generation;
+    std::size_t nbInFlight = 0;
+
+    auto onCompletion = [&](const io_uring_cqe &cqe)
+    {
+        auto tag = io_uring_cqe_get_data64(&cqe);
+
+        // Left over by an earlier call
+        if ((tag >> 32U) != generation)
+        {
+            return;
+        }
+
+        auto &transfer = transferList[tag & 0xFFFFFFFFU];
+
+        transfer.inFlight = false;
+        nbInFlight--;
+
+        if (0 < cqe.res)
+        {
+            transfer.offset += static_cast<std::size_t>(cqe.res);
+        }
+        else if ((cqe.res != -EINTR) && (cqe.res != -EAGAIN))
+        {
+            // Includes a file shrinking under the read (res == 0)
+            transfer.failed = true;
+        }
+    };
+
+    bool ringFailed = false;
+
+    for (;;)
+    {
+        for (std::size_t i = 0; i < requestList.size(); i++)
+        {
+            auto &transfer = transferList[i];
+
+            if (transfer.inFlight || !isPending(i))
+            {
+                continue;
+            }
+
+            auto *sqe = io_uring_get_sqe(&m_ring);
+
+            if (!sqe)
+            {
+                break;
+            }
+
+            auto &data = requestList[i].data;
+            auto size = std::min(data.size() - transfer.offset, maxReadSize);
+
+            io_uring_prep_read(sqe, transfer.fd, data.data() + transfer.offset, static_cast<unsigned>(size), transfer.offset);
+            io_uring_sqe_set_data64(sqe, (generation << 32U) | i);
+
+            transfer.inFlight = true;
+            nbInFlight++;
+        }
+
+        if (nbInFlight == 0)
+        {
+            break;
+        }
+
+        // Interrupted, short of resources or with a full completion queue: the unsubmitted entries stay queued for
+        // the next attempt, after the completions are reaped
+        auto ret = io_uring_submit_and_wait(&m_ring, 1);
+
+        if ((ret < 0) && (ret != -EINTR) && (ret != -EAGAIN) && (ret != -EBUSY))
+        {
+            LOG_ERROR("io_uring submission failed (", -ret, ")");
+            ringFailed = true;
+            break;
+        }
+
+        io_uring_cqe *cqe = nullptr;
+        unsigned head = 0;
+        unsigned nbCompleted = 0;
+
+        io_uring_for_each_cqe(&m_ring, head, cqe)
+        {
+            onCompletion(*cqe);
+            nbCompleted++;
+        }
+
+        io_uring_cq_advance(&m_ring, nbCompleted);
+    }
+
+    if (ringFailed)
+    {
+        // Entries still in the submission queue are never submitted once the ring is given up, those submitted
+        // already are drained before their buffers go
+        auto nbSubmitted = nbInFlight - std::min<std::size_t>(io_uring_sq_ready(&m_ring), nbInFlight);
+
+        while (0 < nbSubmitted)
+        {
+            io_uring_cqe *cqe = nullptr;
+            auto ret = io_uring_wait_cqe(&m_ring, &cqe);
+
+            if ((ret == -EINTR) || (ret == -EAGAIN))
+            {
+                continue;
+            }
+
+            if (ret < 0)
+            {
+                break;
+            }
+
+            auto before = nbInFlight;
+
+            onCompletion(*cqe);
+            io_uring_cqe_seen(&m_ring, cqe);
+
+            nbSubmitted -= (before - nbInFlight);
+        }
+
+        // Not drained: the kernel may still write into these buffers
+        if (0 < nbSubmitted)
+        {
+            for (std::size_t i = 0; i < requestList.size(); i++)
+            {
+                if (transferList[i].inFlight)
+                {
+                    m_orphanList.push_back(std::move(requestList[i].data));
+                }
+            }
+        }
+
+        LOG_WARNING("io_uring disabled, falling back to synchronous reads");
+        m_ready = false;
+    }
+
+    for (std::size_t i = 0; i < requestList.size(); i++)
+    {
+        auto &transfer = transferList[i];
+
+        if (0 <= transfer.fd)
+        {
+            ::close(transfer.fd);
+        }
+
+        requestList[i].valid = !transfer.failed && !transfer.inFlight && !requestList[i].data.empty();
+
+        if (!requestList[i].valid)
+        {
+            requestList[i].data.clear();
+        }
+    }
+}
+} // namespace
+#endif
+
+auto SegmentIO::create(const std::string &name) -> std::shared_ptr<SegmentIO>
+{
+    if (name == "io_uring")
+    {
+#ifdef IO_URING
+        auto backend = std::make_shared<UringSegmentIO>();
+
+        if (backend->isReady())
+        {
+            return backend;
+        }
+
+        LOG_WARNING("io_uring is not available, falling back to synchronous reads");
+#else
+        LOG_WARNING("io_uring support is not built in (USE_IO_URING), falling back to synchronous reads");
+#endif
+    }
+    else if (name != "sync")
+    {
+        LOG_WARNING("Unknown segment I/O backend: ", name, ", falling back to synchronous reads");
+    }
+
+    return std::make_shared<SyncSegmentIO>();
+}
@@ -0,0 +1,358 @@
+/*
+* Copyright (c) 2025 InterDigital CE Patent Holdings SASU
+* Licensed under the License terms of 5GMAG software (the "License").
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at https://www.5g-mag.com/license .
+* Unless required by applicable law or agreed to in writing, software distributed under the License is
+* distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and limitations under the License.
+*/
+
+#include <algorithm>
+#include <common/video/patch_unpacker.h>
+#include <iloj/misc/logger.h>
+#include <iloj/misc/thread.h>
+#include <thread>
+
+using namespace iloj::misc;
+
+namespace miv
+{
+namespace tmiv
+{
+using namespace TMIV::Common;
+using namespace TMIV::MivBitstream;
+} // namespace tmiv
+
+namespace
+{
+// Values of pdu_orientation_index (FlexiblePatchOrientation), four of them exchanging the patch width and height
+enum Orientation
+{
+    Null = 0,
+    Swap,
+    Rot90,
+    Rot180,
+    Rot270,
+    Mirror,
+    MRot90,
+    MRot180
+};
+
+auto isSwapped(int orientation) -> bool
+{
+    return (orientation == Swap) || (orientation == Rot90) || (orientation == Rot270) || (orientation == MRot90);
+}
+
+// Position (x, y) of a patch in the atlas, relative to its corner, to its position in its w x h view rectangle
+auto atlasToView(int orientation, std::size_t x, std::size_t y, std::size_t w, std::size_t h)
+    -> std::pair<std::size_t, std::size_t>
+{
+    switch (orientation)
+    {
+        case Swap:
+            return {y, x};
+        case Rot90:
+            return {y, h - 1 - x};
+        case Rot180:
+            return {w - 1 - x, h - 1 - y};
+        case Rot270:
+            return {w - 1 - y, x};
+        case Mirror:
+            return {w - 1 - x, y};
+        case MRot90:
+            return {w - 1 - y, h - 1 - x};
+        case MRot180:
+            return {x, h - 1 - y};
+        default:
+            return {x, y};
+    }
+}
+
+// Nearest sample of a plane for an atlas position, planes being stretched over the whole atlas frame
+class PlaneSampler
+{
+private:
+    const ImagePlane &m_plane;
+    std::size_t m_atlasWidth;
+    std::size_t m_atlasHeight;
+    bool m_fullSize;
+
+public:
+    PlaneSampler(const ImagePlane &plane, std::size_t atlasWidth, std::size_t atlasHeight)
+        : m_plane{plane},
+          m_atlasWidth{atlasWidth},
+          m_atlasHeight{atlasHeight},
+          m_fullSize{(plane.width == atlasWidth) && (plane.height == atlasHeight)}
+    {
+    }
+    auto isFullSize() const -> bool { return m_fullSize; }
+    auto row(std::size_t y) const -> const std::uint16_t * { return m_plane.data + y * m_plane.stride; }
+    auto operator()(std::size_t y, std::size_t x) const -> std::uint16_t
+    {
+        return m_fullSize ? m_plane(y, x)
+                          : m_plane(y * m_plane.height / m_atlasHeight, x * m_plane.width / m_atlasWidth);
+    }
+};
+
+// Copies count samples of an atlas row to the view, step apart, whole rows of full-size planes going at once
+void copySamples(const PlaneSampler &plane,
+                 std::size_t ay,
+                 std::size_t ax,
+                 std::size_t count,
+                 std::uint16_t *dst,
+                 std::ptrdiff_t step)
+{
+    if (!plane.isFullSize())
+    {
+        for (std::size_t i = 0; i < count; i++)
+        {
+            dst[static_cast<std::ptrdiff_t>(i) * step] = plane(ay, ax + i);
+        }
+    }
+    else if (step == 1)
+    {
+        std::copy_n(plane.row(ay) + ax, count, dst);
+    }
+    else if (step == -1)
+    {
+        std::reverse_copy(plane.row(ay) + ax, plane.row(ay) + ax + count, dst + 1 - count);
+    }
+    else
+    {
+        const auto *src = plane.row(ay) + ax;
+
+        for (std::size_t i = 0; i < count; i++)
+        {
+            dst[static_cast<std::ptrdiff_t>(i) * step] = src[i];
+        }
+    }
+}
+
+struct PatchRef
+{
+    std::size_t atlasIdx;
+    std::size_t patchIdx;
+};
+
+void unpackPatch(const tmiv::AtlasAccessUnit &atlas,
+                 const AtlasFrame &frame,
+                 std::size_t atlasIdx,
+                 std::size_t patchIdx,
+                 ViewFrame &view)
+{
+    const auto &asps = atlas.asps;
+    const auto &pp = atlas.patchParamsList[patchIdx];
+    const auto &btpm = atlas.blockToPatchMap.getPlane(0);
+
+    const std::size_t atlasWidth = asps.asps_frame_width();
+    const std::size_t atlasHeight = asps.asps_frame_height();
+    const std::size_t blockSize = std::size_t{1} << asps.asps_log2_patch_packing_block_size();
+
+    const std::size_t x0 = pp.atlasPatch2dPosX();
+    const std::size_t y0 = pp.atlasPatch2dPosY();
+    const auto sizeX = std::min<std::size_t>(pp.atlasPatch2dSizeX(), atlasWidth - std::min(x0, atlasWidth));
+    const auto sizeY = std::min<std::size_t>(pp.atlasPatch2dSizeY(), atlasHeight - std::min(y0, atlasHeight));
+    const std::size_t offsetU = pp.atlasPatch3dOffsetU();
+    const std::size_t offsetV = pp.atlasPatch3dOffsetV();
+
+    const auto orientation = static_cast<int>(pp.atlasPatchOrientationIndex());
+    const auto w = static_cast<std::size_t>(isSwapped(orientation) ? pp.atlasPatch2dSizeY() : pp.atlasPatch2dSizeX());
+    const auto h = static_cast<std::size_t>(isSwapped(orientation) ? pp.atlasPatch2dSizeX() : pp.atlasPatch2dSizeY());
+
+    const auto hasOccupancy = frame.occupancy.data != nullptr;
+    const auto hasGeometry = frame.geometry.data != nullptr;
+    const auto hasTexture = frame.texture[0].data != nullptr;
+
+    const PlaneSampler occupancy{frame.occupancy, atlasWidth, atlasHeight};
+    const PlaneSampler geometry{frame.geometry, atlasWidth, atlasHeight};
+    const std::array<PlaneSampler, 3> texture = {PlaneSampler{frame.texture[0], atlasWidth, atlasHeight},
+                                                 PlaneSampler{frame.texture[1], atlasWidth, atlasHeight},
+                                                 PlaneSampler{frame.texture[2], atlasWidth, atlasHeight}};
+
+    const auto viewSize = view.width * view.height;
+    const auto occupancyValue = static_cast<std::uint8_t>(atlasIdx + 1);
+
+    for (std::size_t y = 0; y < sizeY; y++)
+    {
+        const auto ay = y0 + y;
+
+        // Runs of blocks of the row owned by the patch, those of later patches being skipped
+        for (std::size_t xBegin = 0; xBegin < sizeX;)
+        {
+            const auto ax = x0 + xBegin;
+            auto xEnd = std::min(sizeX, (ax / blockSize + 1) * blockSize - x0);
+
+            if (btpm(ay / blockSize, ax / blockSize) != patchIdx)
+            {
+                xBegin = xEnd;
+                continue;
+            }
+
+            while ((xEnd < sizeX) && (btpm(ay / blockSize, (x0 + xEnd) / blockSize) == patchIdx))
+            {
+                xEnd = std::min(sizeX, xEnd + blockSize);
+            }
+
+            // Occupancy masks the run into spans, unoccupied pixels keeping what earlier patches wrote
+            for (auto xSpan = xBegin; xSpan < xEnd;)
+            {
+                if (hasOccupancy && (occupancy(ay, x0 + xSpan) == 0))
+                {
+                    xSpan++;
+                    continue;
+                }
+
+                auto xSpanEnd = hasOccupancy ? xSpan + 1 : xEnd;
+
+                while ((xSpanEnd < xEnd) && (occupancy(ay, x0 + xSpanEnd) != 0))
+                {
+                    xSpanEnd++;
+                }
+
+                // A span lands on a view row or column, forward or backward, and is clipped by the view pixel by
+                // pixel only when one of its ends falls out of it
+                const auto count = xSpanEnd - xSpan;
+                const auto [uFirst, vFirst] = atlasToView(orientation, xSpan, y, w, h);
+                const auto [uLast, vLast] = atlasToView(orientation, xSpanEnd - 1, y, w, h);
+
+                if ((offsetU + std::max(uFirst, uLast) < view.width) &&
+                    (offsetV + std::max(vFirst, vLast) < view.height))
+                {
+                    const auto dst = (offsetV + vFirst) * view.width + offsetU + uFirst;
+                    const auto last = (offsetV + vLast) * view.width + offsetU + uLast;
+                    // One sample apart along a view row, one row apart along a view column
+                    const auto step =
+                        (count == 1)
+                            ? std::ptrdiff_t{1}
+                            : (static_cast<std::ptrdiff_t>(last) - static_cast<std::ptrdiff_t>(dst)) /
+                                  static_cast<std::ptrdiff_t>(count - 1);
+
+                    if (hasGeometry)
+                    {
+                        copySamples(geometry, ay, x0 + xSpan, count, view.geometry.data() + dst, step);
+                    }
+
+                    if (hasTexture)
+                    {
+                        for (std::size_t c = 0; c < texture.size(); c++)
+                        {
+                            copySamples(
+                                texture[c], ay, x0 + xSpan, count, view.texture.data() + c * viewSize + dst, step);
+                        }
+                    }
+
+                    for (std::size_t i = 0; i < count; i++)
+                    {
+                        const auto dx = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(dst) +
+                                                                 static_cast<std::ptrdiff_t>(i) * step);
+
+                        view.occupancy[dx] = occupancyValue;
+                        view.patchIdx[dx] = static_cast<std::uint16_t>(patchIdx);
+                    }
+                }
+                else
+                {
+                    for (auto x = xSpan; x < xSpanEnd; x++)
+                    {
+                        const auto [u, v] = atlasToView(orientation, x, y, w, h);
+
+                        if ((view.width <= offsetU + u) || (view.height <= offsetV + v))
+                        {
+                            continue;
+                        }
+
+                        const auto dst = (offsetV + v) * view.width + offsetU + u;
+
+                        if (hasGeometry)
+                        {
+                            view.geometry[dst] = geometry(ay, x0 + x);
+                        }
+
+                        if (hasTexture)
+                        {
+                            for (std::size_t c = 0; c < texture.size(); c++)
+                            {
+                                view.texture[c * viewSize + dst] = texture[c](ay, x0 + x);
+                            }
+                        }
+
+                        view.occupancy[dst] = occupancyValue;
+                        view.patchIdx[dst] = static_cast<std::uint16_t>(patchIdx);
+                    }
+                }
+
+                xSpan = xSpanEnd;
+            }
+
+            xBegin = xEnd;
+        }
+    }
+}
+} // namespace
+
+PatchUnpacker::PatchUnpacker(): m_nbThread{std::max(std::thread::hardware_concurrency(), 1U)} {}
+
+auto PatchUnpacker::unpack(const MivMetadata &au, const std::vector<AtlasFrame> &atlasFrameList) const
+    -> std::vector<ViewFrame>
+{
+    const auto &viewParamsList = au.viewParamsList;
+    std::vector<ViewFrame> viewFrameList(viewParamsList.size());
+
+    for (std::size_t viewIdx = 0; viewIdx < viewParamsList.size(); viewIdx++)
+    {
+        const auto &ci = viewParamsList[viewIdx].ci;
+        auto &view = viewFrameList[viewIdx];
+
+        view.width = ci.ci_projection_plane_width_minus1() + std::size_t{1};
+        view.height = ci.ci_projection_plane_height_minus1() + std::size_t{1};
+    }
+
+    // Patches of each view, in atlas then patch order
+    std::vector<std::vector<PatchRef>> viewPatchList(viewParamsList.size());
+
+    for (std::size_t atlasIdx = 0; atlasIdx < std::min(au.atlas.size(), atlasFrameList.size()); atlasIdx++)
+    {
+        const auto &ppl = au.atlas[atlasIdx].patchParamsList;
+
+        for (std::size_t patchIdx = 0; patchIdx < ppl.size(); patchIdx++)
+        {
+            const auto viewId = ppl[patchIdx].atlasPatchProjectionId();
+            auto iter = std::find_if(viewParamsList.begin(),
+                                     viewParamsList.end(),
+                                     [&](const auto &viewParams) { return viewParams.viewId == viewId; });
+
+            if (iter != viewParamsList.end())
+            {
+                viewPatchList[std::distance(viewParamsList.begin(), iter)].push_back({atlasIdx, patchIdx});
+            }
+            else
+            {
+                LOG_WARNING("Patch #", patchIdx, " of atlas #", atlasIdx, " refers to an unknown view");
+            }
+        }
+    }
+
+    parallel_for(
+        viewFrameList.size(),
+        [&](std::size_t viewIdx)
+        {
+            auto &view = viewFrameList[viewIdx];
+            const auto viewSize = view.width * view.height;
+
+            view.geometry.assign(viewSize, 0);
+            view.texture.assign(3 * viewSize, 0);
+            view.occupancy.assign(viewSize, 0);
+            view.patchIdx.assign(viewSize, tmiv::unusedPatchIdx);
+
+            for (const auto &[atlasIdx, patchIdx] : viewPatchList[viewIdx])
+            {
+                unpackPatch(au.atlas[atlasIdx], atlasFrameList[atlasIdx], atlasIdx, patchIdx, view);
+            }
+        },
+        std::max(1U, std::min<unsigned>(m_nbThread, static_cast<unsigned>(viewFrameList.size()))));
+
+    return viewFrameList;
+}
+} // namespace miv
@@ -12,7 +12,6 @@
 #pragma once
 
 #include <interface/client.h>
-#include <common/stream/item.h>
 
 class MetaInterface: public Client::Interface
 {
@@ -22,8 +21,9 @@ private:
 #else
     std::unique_ptr<Client::Interface> m_realInterface;
 #endif
+    unsigned m_mediaId{};
 
-    std::vector<Item> m_itemList;
+    auto isRemote(unsigned mediaId) const -> bool;
 
 public:
     auto getMediaList() -> const std::vector<std::string> & override;
@@ -31,5 +31,6 @@ public:
     void onConfigure(const std::string &configFile) override;
     void onStartEvent(unsigned mediaId) override;
     void onMediaRequest(unsigned mediaId) override;
+    void onSeekEvent(double position) override;
     void onStopEvent() override;
 };
@@ -0,0 +1,69 @@
+/*
+* Copyright (c) 2025 InterDigital CE Patent Holdings SASU
+* Licensed under the License terms of 5GMAG software (the "License").
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at https://www.5g-mag.com/license .
+* Unless required by applicable law or agreed to in writing, software distributed under the License is
+* distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and limitations under the License.
+*/
+
+#pragma once
+
+#include <common/stream/item.h>
+#include <condition_variable>
+#include <deque>
+#include <iloj/misc/thread.h>
+
+// Background reader pulling the upcoming segments of an item ahead of the pacing clock.
+// The read-ahead window is bounded both in number of segments and in payload bytes.
+class SegmentPrefetcher: public iloj::misc::Service
+{
+public:
+    using Segment = Item::Segment;
+
+private:
+    static constexpr std::size_t maxBatchSize = 8;
+
+    Item *m_item{};
+    std::size_t m_maxSegments{4};
+    std::size_t m_maxBytes{256U << 20U};
+
+    // Serializes open / close, which may be issued from the reader thread and from its owner
+    std::mutex m_control;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::deque<Segment> m_queue;
+    std::size_t m_bytes{};
+    bool m_closing{true};
+    // Set when reading failed, an empty segment being queued last for the reader to report the error
+    bool m_failed{false};
+
+public:
+    void setDepth(std::size_t maxSegments, std::size_t maxBytes)
+    {
+        m_maxSegments = maxSegments;
+        m_maxBytes = maxBytes;
+    }
+    auto isEnabled() const -> bool { return m_maxSegments != 0; }
+    // Starts reading ahead from the current state of item
+    void open(Item &item);
+    // Stops reading ahead and drops the pending segments
+    void close();
+    // Blocks until the next segment is available, returns false once closed or once the queue is drained after a
+    // failed read
+    auto pop(Segment &segment) -> bool;
+
+private:
+    void shutdown();
+    auto isFull() const -> bool
+    {
+        return (m_maxSegments <= m_queue.size()) || (m_maxBytes <= m_bytes && !m_queue.empty());
+    }
+    // Like a single segment before, a batch may overshoot the byte bound
+    auto getRoom() const -> std::size_t { return m_maxSegments - std::min(m_queue.size(), m_maxSegments); }
+
+    void idle() override;
+    void onStop() override;
+};
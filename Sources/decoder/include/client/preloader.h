@@ -0,0 +1,90 @@
+/*
+* Copyright (c) 2025 InterDigital CE Patent Holdings SASU
+* Licensed under the License terms of 5GMAG software (the "License").
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at https://www.5g-mag.com/license .
+* Unless required by applicable law or agreed to in writing, software distributed under the License is
+* distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and limitations under the License.
+*/
+
+#pragma once
+
+#include <client/prefetcher.h>
+#include <common/stream/catalog.h>
+#include <algorithm>
+#include <map>
+#include <optional>
+#include <vector>
+
+// Background reader keeping the first segments of the playlist neighbours of the playing item in memory,
+// so that switching to one of them does not wait for the item to be built nor for its first reads.
+// Scheduling never waits for the preloading thread: an item that is no longer a neighbour is abandoned between two
+// segments, while one that still is goes on.
+class ItemPreloader: public iloj::misc::Service
+{
+public:
+    using Segment = SegmentPrefetcher::Segment;
+
+    struct Entry
+    {
+        // Item state right after the preloaded segments
+        Item item;
+        std::deque<Segment> segmentList;
+    };
+
+private:
+    std::shared_ptr<const Catalog> m_catalog;
+    std::size_t m_maxSegments{};
+    std::size_t m_maxBytes{64U << 20U};
+    bool m_memoryMapping{};
+    std::shared_ptr<SegmentCache> m_segmentCache;
+    std::shared_ptr<SegmentIO> m_segmentIO;
+
+    // Serializes schedule / close, which may be issued from the reader thread and from its owner
+    std::mutex m_control;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::deque<std::size_t> m_pendingList;
+    // Neighbours of the last scheduled item, and the one being preloaded if any
+    std::vector<std::size_t> m_neighbourList;
+    std::optional<std::size_t> m_activeItemId;
+    std::map<std::size_t, Entry> m_entryMap;
+    bool m_closing{true};
+
+public:
+    void setCatalog(std::shared_ptr<const Catalog> catalog) { m_catalog = std::move(catalog); }
+    // maxBytes is shared by all the preloaded items
+    void setDepth(std::size_t maxSegments, std::size_t maxBytes)
+    {
+        m_maxSegments = maxSegments;
+        m_maxBytes = maxBytes;
+    }
+    void setItemOptions(bool memoryMapping,
+                        std::shared_ptr<SegmentCache> segmentCache,
+                        std::shared_ptr<SegmentIO> segmentIO)
+    {
+        m_memoryMapping = memoryMapping;
+        m_segmentCache = std::move(segmentCache);
+        m_segmentIO = std::move(segmentIO);
+    }
+    auto isEnabled() const -> bool { return m_catalog && (m_maxSegments != 0); }
+    // Preloads the neighbours of itemId, entries of any other item are dropped. Does not block on preloading.
+    void schedule(std::size_t itemId);
+    // Stops preloading, the entries already completed are kept
+    void close();
+    // Hands the preloaded entry of itemId over, if any
+    auto take(std::size_t itemId, Entry &entry) -> bool;
+
+private:
+    void shutdown();
+    auto isWanted(std::size_t itemId) const -> bool
+    {
+        return !m_closing &&
+               (std::find(m_neighbourList.begin(), m_neighbourList.end(), itemId) != m_neighbourList.end());
+    }
+
+    void idle() override;
+    void onStop() override;
+};
@@ -11,10 +11,13 @@
 
 #pragma once
 
+#include <client/prefetcher.h>
+#include <client/preloader.h>
 #include <common/stream/item.h>
 #include <iloj/misc/thread.h>
 #include <iloj/misc/time.h>
 #include <interface/client.h>
+#include <optional>
 
 // Error codes
 enum class LocalCode
@@ -28,30 +31,67 @@ class ReaderInterface: public Client::Interface, public iloj::misc::Service
 {
 private:
     std::vector<std::string> m_mediaList;
-    std::vector<Item> m_itemList;
+    // Playing copy of the current catalog item
+    Item m_item;
     std::size_t m_currentItemId{};
     std::size_t m_requestedItemId{0};
+    // Lead of the segments over their presentation, adapted to the decoder margin between the bounds.
+    // The presentation delay is only aligned on it when the timeline restarts, to keep the PTS continuous.
     std::chrono::milliseconds m_lookAhead{1000};
+    std::chrono::milliseconds m_lookAheadMin{250};
+    std::chrono::milliseconds m_lookAheadMax{4000};
+    std::chrono::milliseconds m_presentationDelay{1000};
     iloj::misc::Timer<std::chrono::system_clock> m_timer;
     iloj::misc::Timer<std::chrono::system_clock>::time_point m_t0;
     std::vector<std::chrono::duration<double>> m_delay{};
 
     std::chrono::duration<double> m_checkpoint;
 
+    // Position requested by onSeekEvent, applied by the reader thread between two segments
+    std::mutex m_seekMutex;
+    std::optional<double> m_seekPosition;
+
+    // Segments are served from read-only file mappings instead of being read into memory ("MemoryMapping"). Off by
+    // default: a segment file truncated or replaced in place while mapped makes the reader thread fault (SIGBUS).
+    bool m_memoryMapping{false};
+
+    // Backend reading the segments that are neither mapped nor cached ("sync" or "io_uring")
+    std::shared_ptr<SegmentIO> m_segmentIO;
+    std::string m_segmentIOName{"sync"};
+
+    // Read-ahead window, in segments and bytes (0 segments reads synchronously at the checkpoint)
+    SegmentPrefetcher m_prefetcher;
+    unsigned m_prefetchSegments{4};
+    unsigned m_prefetchBytes{256U << 20U};
+
+    // Recently read segments kept in memory, so that looped content is not read again (0 disables it)
+    std::shared_ptr<SegmentCache> m_segmentCache;
+    unsigned m_segmentCacheBytes{64U << 20U};
+
+    // First segments of the playlist neighbours, read while the current item plays (0 segments disables it)
+    ItemPreloader m_preloader;
+    unsigned m_preloadSegments{0};
+    unsigned m_preloadBytes{64U << 20U};
+    std::deque<SegmentPrefetcher::Segment> m_preloadedList;
+
 public:
     auto getMediaList() -> const std::vector<std::string> & override { return m_mediaList; }
     inline int getMediaId() const override { return m_currentItemId; } 
     void onConfigure(const std::string &configFile) override;
     void onStartEvent(unsigned mediaId) override;
     void onMediaRequest(unsigned mediaId) override;
+    void onSeekEvent(double position) override;
     void onStopEvent() override;
 
 private:
+    void onStop() override;
     void initialize() override;
     void idle() override;
     void finalize() override;
 
     void updateItem();
+    void seekItem(double position);
+    void adaptLookAhead();
 
     bool m_loop_stream = true;
     bool m_stop = false;
@@ -11,22 +11,35 @@
 
 #pragma once
 
+#include <common/decoder/miv.h>
 #include <iloj/media/avcodec.h>
 #include <interface/decoder.h>
 #include <decoder/decoder_haptic.h>
+#include <common/misc/spsc_queue.h>
+#include <decoder/parser_pool.h>
+#include <decoder/input_join.h>
+#include <decoder/frame_aligner.h>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <thread>
 #if defined DASH_STREAMING || defined UVG_RTP_STREAMING
 #include <interface/client.h>
 #ifdef MEASUREMENT_LOG
 typedef std::chrono::steady_clock::time_point timePoint;
 #endif // MEASUREMENT_LOG
 #endif // STREAMING
-#include <common/stream/item.h>
 
 
 class DecoderInterface: public Decoder::Interface, public iloj::misc::Service
 {
 private:
-    static std::array<std::unique_ptr<iloj::gpu::Processor>, VideoStream::Size> g_procVideoDecodingList;
+    // Bound on the atlases of MIV content, the first one being decoded by m_videoDecoderList
+    static constexpr std::size_t maxAtlasCount = 4;
+
+    static std::array<std::array<std::unique_ptr<iloj::gpu::Processor>, VideoStream::Size>, maxAtlasCount>
+        g_procVideoDecodingList;
+    static HANDLE g_sharedContext;
 
 private:
 
@@ -47,22 +60,62 @@ private:
     std::string m_androidFormat{};
 
     std::unique_ptr<HapticDecoder> m_hapticDecoder;
-    std::queue<HapticPacket> m_hapticChunkQueue;
+    // Chunk of each frame, pushed by the parser pool delivery thread and popped as the decoders output the frames.
+    // A chunk without room for all its frames ("ChunkQueueSize") is dropped whole, its frames counted, and never
+    // reaches the codecs.
+    static constexpr std::size_t defaultChunkQueueSize = 4096;
 
     std::unique_ptr<iloj::media::AVCodec::Decoder> m_audioDecoder;
-    std::queue<iloj::misc::Packet<Chunk>> m_audioChunkQueue;
+    common::misc::SpScQueue<iloj::misc::Packet<Chunk>> m_audioChunkQueue{defaultChunkQueueSize};
 
     std::array<std::unique_ptr<iloj::media::AVCodec::Decoder>, 4> m_videoDecoderList;
-    std::queue<iloj::misc::Packet<Chunk>> m_videoChunkQueue;
+    common::misc::SpScQueue<iloj::misc::Packet<Chunk>> m_videoChunkQueue{defaultChunkQueueSize};
 
     iloj::misc::Input<GenericMetadata> m_genericInput;
     std::array<VideoInput, 4> m_videoInputList;
 
+    // Video decoders of one of the other MIV atlases, running alongside those of the first one
+    struct AtlasDecoders
+    {
+        std::array<std::unique_ptr<iloj::media::AVCodec::Decoder>, VideoStream::Size> videoDecoderList;
+        std::array<VideoInput, VideoStream::Size> videoInputList;
+    };
+
+    // Slot k - 1 holds atlas k, allocated on its first segment. The slots never move, so that the decoding thread
+    // reads them without locking: a slot is filled before any metadata referring to its atlas is queued.
+    std::array<std::unique_ptr<AtlasDecoders>, maxAtlasCount - 1> m_atlasDecodersList;
+
     iloj::misc::SpinLock m_locker;
 
     unsigned m_requestedItemId{0};
 
-    std::vector<Item> m_itemList;
+    // MIV parsing state of the item being received, reset on a discontinuity (media switch, seek)
+    miv::Session m_mivSession;
+    int m_mivSessionItemId{-1};
+
+    // Threads extracting the V-PCC frame metadata of a segment ("ParsingThreads" as for MIV)
+    unsigned m_vpccNbThread{std::clamp(std::thread::hardware_concurrency(), 1U, 4U)};
+
+    // Chunks are parsed off the producer thread, m_locker being only held while feeding the decoders
+    ParserPool m_parserPool;
+    unsigned m_nbParsingWorker{2};
+    unsigned m_parsingQueueDepth{8};
+
+    // The decoding thread sleeps until the video streams of the next frame are all decoded, waking up regularly to
+    // follow the metadata input
+    static constexpr std::chrono::milliseconds videoJoinTimeout{100};
+
+    InputJoin<maxAtlasCount * VideoStream::Size> m_videoJoin;
+    // Pairs the joined frames with their metadata on their presentation timestamp ("FrameAlignmentTolerance" in ms,
+    // negative to pair them in order)
+    FrameAligner<maxAtlasCount * VideoStream::Size> m_frameAligner;
+
+    // Frames still in the codecs when the last seek happened, decoded then dropped
+    std::atomic<std::size_t> m_videoDiscardCount{};
+    std::atomic<std::size_t> m_audioDiscardCount{};
+
+    // Written by the decoding thread only
+    std::atomic<double> m_presentationMargin{std::numeric_limits<double>::quiet_NaN()};
 
     //V3C frame decoding FPS measure
 
@@ -106,6 +159,7 @@ public:
     }
     void onChunkEvent(Chunk &&chunk) override;
     void onMediaRequest(unsigned mediaId) override;
+    void onSeekEvent() override;
 
     double getDecoderFPS() override
     {        
@@ -132,6 +186,8 @@ public:
         m_queueMutex.unlock();
     }
 
+    double getPresentationMargin() override { return m_presentationMargin; }
+
     int getAtlasFrameHeight() override { return m_atlasFrameHeight; }
     int getAtlasFrameWidth() override { return m_atlasFrameWidth; }
 
@@ -153,9 +209,26 @@ private:
     void allocateAudioDecoder(std::string avcodec_name);
     void stopAudioDecoder();
 
+    static void allocateVideoDecodingProcessors(std::size_t atlasIdx);
+
     void allocateVideoDecoders(std::string avcodec_name);
+    void allocateAtlasDecoders(std::size_t atlasCount);
+    auto makeVideoDecoder(std::size_t atlasIdx, int videoStreamId, const std::string &avcodec_name)
+        -> std::unique_ptr<iloj::media::AVCodec::Decoder>;
     void stopVideoDecoders();
 
+    // Parses a chunk on a worker of the pool, the returned completion delivering it in chunk order
+    auto parseChunk(iloj::misc::Packet<Chunk> pkt) -> ParserPool::Completion;
+    // Queues the chunk of each frame and then their metadata. Nothing is queued and false returned when the chunk
+    // queue lacks room for all the frames.
+    auto queueVideoFrames(const iloj::misc::Packet<Chunk> &pkt,
+                          std::uint32_t frameCount,
+                          const std::function<iloj::misc::Packet<GenericMetadata>(std::uint32_t)> &makeMetadata)
+        -> bool;
+
+    auto getVideoDecoder(std::size_t atlasIdx, int videoStreamId) -> iloj::media::AVCodec::Decoder &;
+    auto getVideoInput(std::size_t atlasIdx, int videoStreamId) -> VideoInput &;
+
     void stopDecoders();
 
     void allocateHapticDecoder();
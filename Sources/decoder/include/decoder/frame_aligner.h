@@ -0,0 +1,105 @@
+/*
+* Copyright (c) 2025 InterDigital CE Patent Holdings SASU
+* Licensed under the License terms of 5GMAG software (the "License").
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at https://www.5g-mag.com/license .
+* Unless required by applicable law or agreed to in writing, software distributed under the License is
+* distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and limitations under the License.
+*/
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <iloj/misc/packet.h>
+
+// Pairs the next frame metadata with its decoded frames, so that a frame dropped or duplicated by a decoder does not
+// shift the streams for the rest of the item. Both sides carry the presentation timestamp of the frame. Decoded frames
+// older than the metadata are stale and discarded, metadata older than the decoded frames lost its frame and is
+// discarded too. Decoded frames without timestamp are paired in order.
+template<std::size_t N>
+class FrameAligner
+{
+public:
+    enum class Status
+    {
+        // Each input holds the frame of the metadata at its front
+        Aligned,
+        // Stale frames were discarded, an input being left empty
+        Pending,
+        // No frame left for the metadata, to be discarded
+        Orphan
+    };
+
+private:
+    // Negative when disabled
+    std::chrono::duration<double> m_tolerance{0.010};
+
+    std::array<std::size_t, N> m_orphanFrameCount{};
+    std::size_t m_orphanMetadataCount{};
+
+public:
+    void setTolerance(std::chrono::duration<double> tolerance) { m_tolerance = tolerance; }
+    auto getTolerance() const -> std::chrono::duration<double> { return m_tolerance; }
+
+    // Null inputs do not take part in the alignment, the others are not empty
+    template<typename T>
+    auto align(const std::array<iloj::misc::Input<T> *, N> &inputList, std::chrono::duration<double> pts) -> Status
+    {
+        if (m_tolerance.count() < 0)
+        {
+            return Status::Aligned;
+        }
+
+        // Unstamped by the decoder
+        for (auto *input : inputList)
+        {
+            if (input && (pts.count() != 0) && (input->front()->getMetadata().getTimeStamp().count() == 0))
+            {
+                return Status::Aligned;
+            }
+        }
+
+        auto status = Status::Aligned;
+
+        for (std::size_t k = 0; k < N; k++)
+        {
+            auto *input = inputList[k];
+
+            if (!input)
+            {
+                continue;
+            }
+
+            while (!input->empty() && (input->front()->getMetadata().getTimeStamp() < pts - m_tolerance))
+            {
+                input->pop();
+                m_orphanFrameCount[k]++;
+            }
+
+            if (input->empty())
+            {
+                status = Status::Pending;
+            }
+            else if (pts + m_tolerance < input->front()->getMetadata().getTimeStamp())
+            {
+                m_orphanMetadataCount++;
+                return Status::Orphan;
+            }
+        }
+
+        return status;
+    }
+
+    // Decoded frames of input k discarded as stale
+    auto getOrphanFrameCount(std::size_t k) const -> std::size_t { return m_orphanFrameCount[k]; }
+    auto getOrphanMetadataCount() const -> std::size_t { return m_orphanMetadataCount; }
+
+    void reset()
+    {
+        m_orphanFrameCount = {};
+        m_orphanMetadataCount = {};
+    }
+};
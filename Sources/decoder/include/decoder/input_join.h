@@ -0,0 +1,94 @@
+/*
+* Copyright (c) 2025 InterDigital CE Patent Holdings SASU
+* Licensed under the License terms of 5GMAG software (the "License").
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at https://www.5g-mag.com/license .
+* Unless required by applicable law or agreed to in writing, software distributed under the License is
+* distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and limitations under the License.
+*/
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <iloj/misc/packet.h>
+
+// Blocks until each input of a set holds a packet, sleeping on the inputs themselves instead of polling them.
+// Inputs are waited for one after the other, so the join returns as soon as the last one is filled. Closing an
+// input cancels the join. The time spent waiting for each input is recorded, along with the number of joins each
+// one held up last.
+template<std::size_t N>
+class InputJoin
+{
+public:
+    enum class Status
+    {
+        Ready,
+        Timeout,
+        Closed
+    };
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::array<std::chrono::nanoseconds, N> m_waitTime{};
+    std::array<std::size_t, N> m_lastCount{};
+    std::size_t m_joinCount{};
+    std::size_t m_timeoutCount{};
+
+public:
+    // Null inputs do not take part in the join
+    template<typename T>
+    auto join(const std::array<iloj::misc::Input<T> *, N> &inputList, std::chrono::milliseconds timeout) -> Status
+    {
+        const auto deadline = Clock::now() + timeout;
+        std::size_t last = N;
+
+        for (std::size_t k = 0; k < N; k++)
+        {
+            auto *input = inputList[k];
+
+            if (!input || !input->empty())
+            {
+                continue;
+            }
+
+            const auto start = Clock::now();
+            const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - start);
+            const auto filled = (0 < remaining.count()) && input->wait_for(remaining);
+
+            m_waitTime[k] += Clock::now() - start;
+            last = k;
+
+            if (!filled)
+            {
+                if (!input->is_open())
+                {
+                    return Status::Closed;
+                }
+
+                m_timeoutCount++;
+                return Status::Timeout;
+            }
+        }
+
+        if (last < N)
+        {
+            m_lastCount[last]++;
+        }
+
+        m_joinCount++;
+
+        return Status::Ready;
+    }
+
+    auto getJoinCount() const -> std::size_t { return m_joinCount; }
+    auto getTimeoutCount() const -> std::size_t { return m_timeoutCount; }
+    auto getWaitTime(std::size_t k) const -> std::chrono::nanoseconds { return m_waitTime[k]; }
+    // Joins completed by a packet of input k
+    auto getLastCount(std::size_t k) const -> std::size_t { return m_lastCount[k]; }
+
+    void reset() { *this = {}; }
+};
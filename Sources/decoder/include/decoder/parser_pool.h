@@ -0,0 +1,89 @@
+/*
+* Copyright (c) 2025 InterDigital CE Patent Holdings SASU
+* Licensed under the License terms of 5GMAG software (the "License").
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at https://www.5g-mag.com/license .
+* Unless required by applicable law or agreed to in writing, software distributed under the License is
+* distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and limitations under the License.
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iloj/misc/thread.h>
+#include <map>
+#include <memory>
+#include <vector>
+
+// Parses chunks off the producer thread. Jobs run concurrently on a pool of workers, each one returning a completion
+// which is then run on a single delivery thread, in submission order. Stateless parsing belongs to the job, anything
+// depending on the previous chunks or feeding the decoders to the completion.
+class ParserPool: public iloj::misc::Service
+{
+public:
+    using Completion = std::function<void()>;
+    using Job = std::function<Completion()>;
+
+private:
+    class Worker: public iloj::misc::Service
+    {
+    private:
+        ParserPool &m_pool;
+
+    public:
+        explicit Worker(ParserPool &pool): m_pool{pool} {}
+
+    private:
+        void idle() override
+        {
+            if (!m_pool.runJob())
+            {
+                finish();
+            }
+        }
+    };
+
+    std::vector<std::unique_ptr<Worker>> m_workerList;
+
+    // Serializes open / close
+    std::mutex m_control;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::deque<std::pair<std::uint64_t, Job>> m_jobQueue;
+    std::map<std::uint64_t, Completion> m_completionMap;
+    // Sequence number of the next job submitted, and of the next completion to run
+    std::uint64_t m_submitId{};
+    std::uint64_t m_deliveryId{};
+    std::size_t m_maxPending{8};
+    bool m_closing{true};
+
+public:
+    ParserPool() = default;
+    ~ParserPool() override { close(); }
+    ParserPool(const ParserPool &) = delete;
+    ParserPool(ParserPool &&) = delete;
+    auto operator=(const ParserPool &) -> ParserPool & = delete;
+    auto operator=(ParserPool &&) -> ParserPool & = delete;
+
+    // Starts nbWorker workers, at most maxPending jobs being submitted and not yet delivered
+    void open(unsigned nbWorker, std::size_t maxPending);
+    // Stops the workers and drops the pending jobs, a running completion being completed first
+    void close();
+    // Blocks while maxPending jobs are pending, returns false once closed
+    auto submit(Job job) -> bool;
+    // Blocks until every job submitted so far is delivered
+    void flush();
+
+private:
+    void shutdown();
+    // Returns false once closing, for the worker to leave its loop
+    auto runJob() -> bool;
+
+    void idle() override;
+    void onStop() override;
+};
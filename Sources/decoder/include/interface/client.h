@@ -12,6 +12,7 @@
 #pragma once
 
 #include "decoder.h"
+#include <common/stream/catalog.h>
 
 namespace Client
 {
@@ -19,6 +20,7 @@ class Interface
 {
 protected:
     Decoder::Interface *m_decoderInterface = nullptr;
+    std::shared_ptr<const Catalog> m_catalog;
 
 public:
     Interface(){};
@@ -28,11 +30,14 @@ public:
     auto operator=(const Interface &) -> Interface & = delete;
     auto operator=(Interface &&other) noexcept -> Interface & = default;
     void setDecoderInterface(Decoder::Interface *decoderInterface) { m_decoderInterface = decoderInterface; }
+    void setCatalog(std::shared_ptr<const Catalog> catalog) { m_catalog = std::move(catalog); }
     virtual auto getMediaList() -> const std::vector<std::string> & = 0;
     virtual int getMediaId() const = 0;
     virtual void onConfigure(const std::string &configFile) = 0;
     virtual void onStartEvent(unsigned mediaId) = 0;
     virtual void onMediaRequest(unsigned mediaId) = 0;
+    // Resumes the current media from the random access point preceding position (in seconds)
+    virtual void onSeekEvent(double position) = 0;
     virtual void onStopEvent() = 0;
 };
 
@@ -12,6 +12,7 @@
 #pragma once
 
 #include "scheduler.h"
+#include <common/stream/catalog.h>
 #include <common/stream/chunk.h>
 
 typedef void(*OnErrorEventCallback)(unsigned int, unsigned int);
@@ -23,6 +24,7 @@ class Interface
 protected:
     Scheduler::Interface *m_schedulerInterface = nullptr;
     OnErrorEventCallback m_onErrorEventCallback = nullptr;
+    std::shared_ptr<const Catalog> m_catalog;
 
 public:
     Interface(){};
@@ -32,15 +34,20 @@ public:
     auto operator=(const Interface &) -> Interface & = delete;
     auto operator=(Interface &&other) noexcept -> Interface & = default;
     void setSchedulerInterface(Scheduler::Interface *schedulerInterface) { m_schedulerInterface = schedulerInterface; }
+    void setCatalog(std::shared_ptr<const Catalog> catalog) { m_catalog = std::move(catalog); }
     virtual void onConfigure(const std::string &configFile) = 0;
     virtual void setSharedOpenGLContext(HANDLE hwContext) = 0;
     virtual void onStartEvent(unsigned mediaId) = 0;
     virtual void onChunkEvent(Chunk&& chunk) = 0;
     virtual void onStopEvent() = 0;
+    // Drops everything received before, the decoders keep running
+    virtual void onSeekEvent() = 0;
     virtual void setOnErrorEventCallback(OnErrorEventCallback ec) { m_onErrorEventCallback = ec; }
     virtual auto getOnErrorEventCallback() -> OnErrorEventCallback { return m_onErrorEventCallback; }
     virtual void onMediaRequest(unsigned mediaId) = 0;
     virtual double getDecoderFPS()  = 0;
+    // Smoothed lead, in seconds, of the decoded frames over their presentation time (NaN until measured)
+    virtual double getPresentationMargin() = 0;
     virtual void flushFPSMeasures()  = 0;
     virtual int getAtlasFrameHeight() = 0;
     virtual int getAtlasFrameWidth() = 0;
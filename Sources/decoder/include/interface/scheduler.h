@@ -42,6 +42,8 @@ public:
     virtual void onConfigure(const std::string &configFile) = 0;
     virtual void onStartEvent() = 0;
     virtual void onStopEvent() = 0;
+    // Drops the pending samples, the schedulers keep running
+    virtual void onSeekEvent() = 0;
 };
 
 } // namespace Scheduler
@@ -110,6 +110,12 @@ public:
         try
         {
             LOG_INFO("onConfigure");
+
+            // The playlist is parsed once and shared by the client and decoder interfaces
+            auto catalog = Catalog::fromConfig(configFile);
+            m_clientInterface->setCatalog(catalog);
+            m_decoderInterface->setCatalog(catalog);
+
             m_clientInterface->onConfigure(configFile);
             m_decoderInterface->onConfigure(configFile);
             m_schedulerInterface->onConfigure(configFile);
@@ -154,6 +160,18 @@ public:
             LOG_ERROR(e.what());
         }
     }
+    void onSeekEvent(double position)
+    {
+        try
+        {
+            LOG_INFO("onSeekEvent position=", position);
+            m_clientInterface->onSeekEvent(position);
+        }
+        catch (std::exception e)
+        {
+            LOG_ERROR(e.what());
+        }
+    }
     void setOnErrorEventCallback(OnErrorEventCallback ec)
     {
         try
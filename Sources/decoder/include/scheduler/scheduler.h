@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <iloj/media/descriptor.h>
 #include <iloj/misc/packet.h>
@@ -26,7 +27,8 @@ private:
     {
     private:
         bool m_forceDecodersSynchro = true;   
-        std::chrono::duration<double> m_offset{0};
+        // In seconds, moved along by every scheduler thread and reset by the seek path
+        std::atomic<double> m_offset{0};
         std::chrono::duration<double> m_initTime{0};
 
     public:
@@ -35,11 +37,13 @@ private:
         void setForceDecodersSynchro(bool force_synchro) { m_forceDecodersSynchro = force_synchro; }
         void reset()
         {
-            m_offset = (std::chrono::duration<double>) 0;
+            m_offset = 0;
             m_initTime = now();
         }
         std::chrono::duration<double> getTimeRelative(std::chrono::duration<double> time) { return time - m_initTime;}
-        std::chrono::duration<double> getOffset() { return m_offset; }
+        std::chrono::duration<double> getOffset() { return std::chrono::duration<double>{m_offset}; }
+        // The samples of the previous timeline are dropped by the schedulers themselves
+        void flush() { m_offset = 0; }
     };
 
 
@@ -50,6 +54,7 @@ private:
         Audio::Interface *m_audioInterface = nullptr;
         std::chrono::milliseconds m_latency{0};
         AudioInput m_input;
+        std::atomic<unsigned> m_discardCount{0};
 
     public:
         AudioScheduler(MasterClock *clock) { m_masterClock = clock; }
@@ -57,6 +62,7 @@ private:
         void setInterface(Audio::Interface *audioInterface) { m_audioInterface = audioInterface; }
         void setLatency(std::chrono::milliseconds latency) { m_latency = latency; }
         auto getInput() -> AudioInput & { return m_input; }
+        void flush() { m_discardCount = m_input.pending(); }
 
     private:
         void initialize() override;
@@ -72,6 +78,7 @@ private:
         Video::Interface *m_videoInterface = nullptr;
         std::chrono::milliseconds m_jitter{5};
         DecodedVideoInput m_input;
+        std::atomic<unsigned> m_discardCount{0};
 
         
         //std::chrono::milliseconds m_offset{0};
@@ -83,6 +90,7 @@ private:
         void setJitter(std::chrono::milliseconds jitter) { m_jitter = jitter; }
         
         auto getInput() -> DecodedVideoInput & { return m_input; }
+        void flush() { m_discardCount = m_input.pending(); }
 
     private:
         void initialize() override;
@@ -97,6 +105,7 @@ private:
         Haptic::Interface *m_hapticInterface = nullptr;
         std::chrono::milliseconds m_latency{0};
         HapticInput m_input;
+        std::atomic<unsigned> m_discardCount{0};
         
     public:
         HapticScheduler(MasterClock *clock) { m_masterClock = clock; }
@@ -104,6 +113,7 @@ private:
         void setInterface(Haptic::Interface *hapticInterface) { m_hapticInterface = hapticInterface; }
         void setLatency(std::chrono::milliseconds latency) { m_latency = latency; }
         auto getInput() -> HapticInput & { return m_input; }
+        void flush() { m_discardCount = m_input.pending(); }
 
     private:
         void initialize() override;
@@ -123,6 +133,7 @@ public:
     void onConfigure(const std::string &configFile) override;
     void onStartEvent() override;
     void onStopEvent() override;
+    void onSeekEvent() override;
     auto getAudioInput() -> AudioInput & override { return m_audioScheduler.getInput(); }
     auto getVideoInput() -> DecodedVideoInput & override { return m_videoScheduler.getInput(); }
     auto getHapticInput() -> HapticInput & override { return m_hapticScheduler.getInput(); }
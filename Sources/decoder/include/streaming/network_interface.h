@@ -64,14 +64,6 @@ private:
     /// </summary>
     std::atomic_bool m_closing{false};
     /// <summary>
-    /// List of Items containing properties of the contents, used by ClientInterface:
-    /// - media name (must be the same in the themes file)
-    /// - server name
-    /// - url on the server
-    /// - framerate
-    /// </summary>
-    std::vector<Item> m_itemList;
-    /// <summary>
     /// hold the id of the requested media until the update of the current media can be done
     /// </summary>
     std::size_t m_requestMediaId{0};
@@ -113,17 +105,17 @@ private:
     /// </summary>
     std::string readHostAddress(const iloj::misc::JSON::Object &serverProperties) const;
     /// <summary>
-    /// Parse the Networking JSON::Object of the config file to fill in m_itemList and m_remoteHosts
+    /// Parse the Networking JSON::Object of the config file to fill in m_remoteHosts
     /// </summary>
     void readNetworkConfig(const iloj::misc::JSON::Object &jsonNetworking);
     /// <summary>
-    /// shortcut to the Video Stream of an Item in m_itemList
+    /// shortcut to the Video Stream of an Item of the catalog
     /// the Video Stream contains:
     /// - typeId
     /// - framerate
     /// - server name
     /// </summary>
-    const Item::Stream &getItemStream(unsigned int mediaId) const { return m_itemList[mediaId].getStreams()[0]; }
+    const Item::Stream &getItemStream(unsigned int mediaId) const { return m_catalog->getItem(mediaId).getStreams()[0]; }
     /// <summary>
     /// called at the start and at a media request
     /// update the following:
@@ -167,6 +159,7 @@ public:
     void onConfigure(const std::string &configFile) override;
     void onStartEvent(unsigned mediaId) override;
     void onMediaRequest(unsigned mediaId) override;
+    void onSeekEvent(double position) override;
     void onStopEvent() override
     {
         LOG_INFO("NetworkInterface::onStopEvent");
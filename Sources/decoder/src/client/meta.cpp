@@ -39,8 +39,6 @@ int MetaInterface::getMediaId() const
 
 void MetaInterface::onConfigure(const std::string &configFile)
 {
-    auto json = JSON::Object::fromFile(configFile);
-
 #if defined DASH_STREAMING || defined UVG_RTP_STREAMING
     LOG_INFO("MetaInterface::onConfigure in remote mode");
     m_realInterface[0] = std::make_unique<NetworkInterface>();
@@ -51,32 +49,7 @@ void MetaInterface::onConfigure(const std::string &configFile)
     m_realInterface = std::make_unique<ReaderInterface>();
 #endif
 
-    const auto libraryPath = FileSystem::Path::getAbsolute(
-        {json.getItem<JSON::String>("Library").getValue(), FileSystem::Path{configFile}.getParent()});
-    if (!FileSystem::File{libraryPath}.exist())
-    {
-        LOG_ERROR("Library file not found: ", libraryPath.toString());
-        return;
-    }
-
-    auto jsonLibrary = JSON::Object::fromFile(libraryPath.toString());
-    if (jsonLibrary.isEmpty())
-    {
-        LOG_ERROR("Library is unreadable");
-        return;
-    }
-
-    const auto &jsonPlaylist = jsonLibrary.getItem<JSON::Array>("Playlist");
-    const auto nbChannel = jsonPlaylist.getSize();
-    if (!nbChannel)
-    {
-        LOG_ERROR("Playlist data is either missing or empty");
-        return;
-    }
-
-    m_itemList = Item::makeItemList(jsonLibrary, nbChannel, true);
-
-    if (m_itemList.empty())
+    if (!m_catalog)
     {
         LOG_ERROR("Playlist is empty or unreadable");
         return;
@@ -85,24 +58,26 @@ void MetaInterface::onConfigure(const std::string &configFile)
 #if defined DASH_STREAMING || defined UVG_RTP_STREAMING
     // mode is remote
     m_realInterface[0]->setDecoderInterface(m_decoderInterface);
+    m_realInterface[0]->setCatalog(m_catalog);
     m_realInterface[0]->onConfigure(configFile);
 
     // mode is local
     m_realInterface[1]->setDecoderInterface(m_decoderInterface);
+    m_realInterface[1]->setCatalog(m_catalog);
     m_realInterface[1]->onConfigure(configFile);
 #else
     m_realInterface->setDecoderInterface(m_decoderInterface);
+    m_realInterface->setCatalog(m_catalog);
     m_realInterface->onConfigure(configFile);
 #endif
 }
 
 void MetaInterface::onStartEvent(unsigned mediaId) 
 { 
+    m_mediaId = mediaId;
+
 #if defined DASH_STREAMING || defined UVG_RTP_STREAMING
-    if ( (m_itemList[mediaId].getMode().compare("dash") == 0)
-        || (m_itemList[mediaId].getMode().compare("rtp") == 0)
-        || (m_itemList[mediaId].getMode().compare("webrtc") == 0)
-        )
+    if (isRemote(mediaId))
     {
         m_realInterface[0]->onStartEvent(mediaId);
     }
@@ -117,11 +92,10 @@ void MetaInterface::onStartEvent(unsigned mediaId)
 
 void MetaInterface::onMediaRequest(unsigned mediaId)
 {
+    m_mediaId = mediaId;
+
 #if defined DASH_STREAMING || defined UVG_RTP_STREAMING
-    if ((m_itemList[mediaId].getMode().compare("dash") == 0)
-        || (m_itemList[mediaId].getMode().compare("rtp") == 0)
-        || (m_itemList[mediaId].getMode().compare("webrtc") == 0)
-        )
+    if (isRemote(mediaId))
     {
         m_realInterface[0]->onMediaRequest(mediaId);
     }
@@ -134,6 +108,29 @@ void MetaInterface::onMediaRequest(unsigned mediaId)
 #endif
 }
 
+void MetaInterface::onSeekEvent(double position)
+{
+#if defined DASH_STREAMING || defined UVG_RTP_STREAMING
+    if (isRemote(m_mediaId))
+    {
+        m_realInterface[0]->onSeekEvent(position);
+    }
+    else
+    {
+        m_realInterface[1]->onSeekEvent(position);
+    }
+#else
+    m_realInterface->onSeekEvent(position);
+#endif
+}
+
+auto MetaInterface::isRemote(unsigned mediaId) const -> bool
+{
+    const auto &mode = m_catalog->getMode(mediaId);
+
+    return (mode.compare("dash") == 0) || (mode.compare("rtp") == 0) || (mode.compare("webrtc") == 0);
+}
+
 void MetaInterface::onStopEvent()
 {
 #if defined DASH_STREAMING || defined UVG_RTP_STREAMING
@@ -0,0 +1,128 @@
+/*
+* Copyright (c) 2025 InterDigital CE Patent Holdings SASU
+* Licensed under the License terms of 5GMAG software (the "License").
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at https://www.5g-mag.com/license .
+* Unless required by applicable law or agreed to in writing, software distributed under the License is
+* distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and limitations under the License.
+*/
+
+#include <algorithm>
+#include <client/prefetcher.h>
+#include <iloj/misc/logger.h>
+
+void SegmentPrefetcher::open(Item &item)
+{
+    std::lock_guard<std::mutex> control(m_control);
+
+    shutdown();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_item = &item;
+        m_closing = false;
+        m_failed = false;
+    }
+
+    start();
+}
+
+void SegmentPrefetcher::close()
+{
+    std::lock_guard<std::mutex> control(m_control);
+
+    shutdown();
+}
+
+void SegmentPrefetcher::shutdown()
+{
+    onStop();
+    stop();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_item = nullptr;
+    m_queue.clear();
+    m_bytes = 0;
+}
+
+auto SegmentPrefetcher::pop(Segment &segment) -> bool
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    m_cond.wait(lock, [this]() { return m_closing || m_failed || !m_queue.empty(); });
+
+    if (m_closing || m_queue.empty())
+    {
+        return false;
+    }
+
+    segment = std::move(m_queue.front());
+    m_queue.pop_front();
+    m_bytes -= std::get<Chunk>(segment).size();
+
+    m_cond.notify_all();
+
+    return true;
+}
+
+void SegmentPrefetcher::idle()
+{
+    std::size_t nbSegment{};
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        m_cond.wait(lock, [this]() { return m_closing || (!m_failed && !isFull()); });
+
+        // Left until stop joins the thread
+        if (m_closing)
+        {
+            finish();
+            return;
+        }
+
+        nbSegment = std::min(getRoom(), maxBatchSize);
+    }
+
+    // Only this thread advances the item while the prefetcher is open, so the read happens unlocked
+    try
+    {
+        auto segmentList = m_item->next(nbSegment);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!m_closing)
+        {
+            for (auto &segment : segmentList)
+            {
+                m_bytes += std::get<Chunk>(segment).size();
+                m_queue.push_back(std::move(segment));
+            }
+
+            m_cond.notify_all();
+        }
+    }
+    catch (std::exception &e)
+    {
+        LOG_ERROR("SegmentPrefetcher: ", e.what());
+
+        // The thread keeps running until closed, the reader getting an empty segment to report the invalid file
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!m_closing)
+        {
+            m_queue.emplace_back();
+            m_failed = true;
+            m_cond.notify_all();
+        }
+    }
+}
+
+void SegmentPrefetcher::onStop()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_closing = true;
+    m_cond.notify_all();
+}
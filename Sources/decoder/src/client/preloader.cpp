@@ -0,0 +1,194 @@
+/*
+* Copyright (c) 2025 InterDigital CE Patent Holdings SASU
+* Licensed under the License terms of 5GMAG software (the "License").
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at https://www.5g-mag.com/license .
+* Unless required by applicable law or agreed to in writing, software distributed under the License is
+* distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and limitations under the License.
+*/
+
+#include <algorithm>
+#include <client/preloader.h>
+#include <iloj/misc/logger.h>
+#include <iloj/misc/string.h>
+
+using namespace iloj::misc;
+
+void ItemPreloader::schedule(std::size_t itemId)
+{
+    std::lock_guard<std::mutex> control(m_control);
+
+    const auto nbItem = m_catalog->getNumberOfItems();
+    std::vector<std::size_t> neighbourList;
+
+    for (auto neighbourId : {(itemId + 1) % nbItem, (itemId + nbItem - 1) % nbItem})
+    {
+        // Remote items are not read by the reader
+        if ((neighbourId != itemId) && !to_lower(m_catalog->getMode(neighbourId)).compare("local") &&
+            (std::find(neighbourList.begin(), neighbourList.end(), neighbourId) == neighbourList.end()))
+        {
+            neighbourList.push_back(neighbourId);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        for (auto iter = m_entryMap.begin(); iter != m_entryMap.end();)
+        {
+            if (std::find(neighbourList.begin(), neighbourList.end(), iter->first) == neighbourList.end())
+            {
+                iter = m_entryMap.erase(iter);
+            }
+            else
+            {
+                iter++;
+            }
+        }
+
+        m_pendingList.clear();
+
+        for (auto neighbourId : neighbourList)
+        {
+            // One still being preloaded goes on
+            if ((m_entryMap.find(neighbourId) == m_entryMap.end()) && (m_activeItemId != neighbourId))
+            {
+                m_pendingList.push_back(neighbourId);
+            }
+        }
+
+        m_neighbourList = std::move(neighbourList);
+        m_cond.notify_all();
+
+        // Running until closed
+        if (!m_closing)
+        {
+            return;
+        }
+
+        m_closing = false;
+    }
+
+    start();
+}
+
+void ItemPreloader::close()
+{
+    std::lock_guard<std::mutex> control(m_control);
+
+    shutdown();
+}
+
+auto ItemPreloader::take(std::size_t itemId, Entry &entry) -> bool
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto iter = m_entryMap.find(itemId);
+
+    if (iter == m_entryMap.end())
+    {
+        return false;
+    }
+
+    entry = std::move(iter->second);
+    m_entryMap.erase(iter);
+
+    return true;
+}
+
+void ItemPreloader::shutdown()
+{
+    onStop();
+    stop();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pendingList.clear();
+    m_neighbourList.clear();
+}
+
+void ItemPreloader::idle()
+{
+    std::size_t itemId{};
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        m_cond.wait(lock, [this]() { return m_closing || !m_pendingList.empty(); });
+
+        // Left until stop joins the thread
+        if (m_closing)
+        {
+            finish();
+            return;
+        }
+
+        itemId = m_pendingList.front();
+        m_pendingList.pop_front();
+        m_activeItemId = itemId;
+    }
+
+    try
+    {
+        // Building the item probes its segments if they are not indexed yet, outside the catalog lock
+        Entry entry{m_catalog->getItem(itemId), {}};
+        std::size_t bytes{};
+
+        entry.item.setMemoryMapping(m_memoryMapping);
+        entry.item.setSegmentCache(m_segmentCache);
+        entry.item.setSegmentIO(m_segmentIO);
+
+        const auto maxBytes = m_maxBytes / 2;
+
+        // Items shorter than the preloading depth are not looped over
+        while ((entry.segmentList.size() < m_maxSegments) && (bytes < maxBytes) && !entry.item.isAtEnd())
+        {
+            auto segment = entry.item.next();
+            auto size = std::get<Chunk>(segment).size();
+
+            entry.segmentList.push_back(std::move(segment));
+            bytes += size;
+
+            // An invalid segment is left for the reader to report
+            if (size == 0)
+            {
+                break;
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            // Abandoned once closed or no longer a neighbour
+            if (!isWanted(itemId))
+            {
+                m_activeItemId.reset();
+                return;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (isWanted(itemId))
+        {
+            LOG_INFO("ItemPreloader: ", entry.segmentList.size(), " segment(s) of ", entry.item.getName(), " ready");
+
+            m_entryMap[itemId] = std::move(entry);
+        }
+
+        m_activeItemId.reset();
+    }
+    catch (std::exception &e)
+    {
+        LOG_ERROR("ItemPreloader: ", e.what());
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_activeItemId.reset();
+    }
+}
+
+void ItemPreloader::onStop()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_closing = true;
+    m_cond.notify_all();
+}
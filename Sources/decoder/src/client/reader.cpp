@@ -10,6 +10,8 @@
 */
 
 #include <client/reader.h>
+#include <algorithm>
+#include <cmath>
 #include <iloj/misc/filesystem.h>
 
 using namespace iloj::misc;
@@ -23,47 +25,127 @@ void ReaderInterface::onConfigure(const std::string &configFile)
         LOG_ERROR("Configuration file not found: ", configFile);
     }
 
-    auto dataDirectory = FileSystem::Path{configFile}.getParent();
-    auto jsonPath = FileSystem::Path::getAbsolute(
-        {JSON::Object::fromFile(configFile).getItem<JSON::String>("Library").getValue(), dataDirectory});
+    auto json = JSON::Object::fromFile(configFile);
 
-    if (!FileSystem::File{jsonPath}.exist())
+    if (auto &item = json.getItem<JSON::Object>("Reader").getItem("LookAhead"))
     {
-        LOG_ERROR("Library file not found: ", jsonPath.toString());
+        m_lookAhead = std::chrono::milliseconds{item.as<int>()};
     }
 
-    auto config = JSON::Object::fromFile(jsonPath.toString());
+    if (auto &item = json.getItem<JSON::Object>("Reader").getItem("LookAheadMin"))
+    {
+        m_lookAheadMin = std::chrono::milliseconds{item.as<int>()};
+    }
+
+    if (auto &item = json.getItem<JSON::Object>("Reader").getItem("LookAheadMax"))
+    {
+        m_lookAheadMax = std::chrono::milliseconds{item.as<int>()};
+    }
+
+    m_lookAheadMax = std::max(m_lookAheadMin, m_lookAheadMax);
+    m_lookAhead = std::clamp(m_lookAhead, m_lookAheadMin, m_lookAheadMax);
+
+    if (auto &item = json.getItem<JSON::Object>("Reader").getItem("MemoryMapping"))
+    {
+        m_memoryMapping = item.as<bool>();
+    }
+
+    if (json.getItem<JSON::Object>("Reader").hasItem("IOBackend"))
+    {
+        m_segmentIOName = json.getItem<JSON::Object>("Reader").getItem<JSON::String>("IOBackend").getValue();
+    }
+
+    if (auto &item = json.getItem<JSON::Object>("Reader").getItem("PrefetchSegments"))
+    {
+        m_prefetchSegments = item.as<unsigned>();
+    }
+
+    if (auto &item = json.getItem<JSON::Object>("Reader").getItem("PrefetchBytes"))
+    {
+        m_prefetchBytes = item.as<unsigned>();
+    }
+
+    if (auto &item = json.getItem<JSON::Object>("Reader").getItem("SegmentCacheBytes"))
+    {
+        m_segmentCacheBytes = item.as<unsigned>();
+    }
+
+    if (auto &item = json.getItem<JSON::Object>("Reader").getItem("PreloadSegments"))
+    {
+        m_preloadSegments = item.as<unsigned>();
+    }
 
-    config.setItem<JSON::String>("BaseDirectory", jsonPath.getParent().toString());
+    if (auto &item = json.getItem<JSON::Object>("Reader").getItem("PreloadBytes"))
+    {
+        m_preloadBytes = item.as<unsigned>();
+    }
 
-    const auto &playList = config.getItem<JSON::Array>("Playlist");
+    m_segmentIO = SegmentIO::create(m_segmentIOName);
 
-    auto nbChannel = playList.getSize();
+    if (m_memoryMapping && (m_segmentIO->getName() != "sync"))
+    {
+        LOG_WARNING("Reader: segments are memory-mapped, ", m_segmentIO->getName(), " only serves unmappable files");
+    }
 
-    m_itemList.clear();
+    m_prefetcher.setDepth(m_prefetchSegments, m_prefetchBytes);
 
-    for (std::size_t channelId = 0; channelId < nbChannel; channelId++)
+    if (m_segmentCacheBytes != 0)
     {
-        m_itemList.emplace_back(config, channelId, true);
-        m_mediaList.emplace_back(m_itemList.back().getName());
+        m_segmentCache = std::make_shared<SegmentCache>(m_segmentCacheBytes);
+    }
+    else
+    {
+        m_segmentCache.reset();
     }
 
-    config.toFile(jsonPath.toString());
+    m_preloader.setCatalog(m_catalog);
+    m_preloader.setDepth(m_preloadSegments, m_preloadBytes);
+    m_preloader.setItemOptions(m_memoryMapping, m_segmentCache, m_segmentIO);
+
+    if (m_catalog)
+    {
+        m_mediaList = m_catalog->getNameList();
+    }
 }
 
 void ReaderInterface::onStartEvent(unsigned mediaId)
 {
     LOG_INFO("ReaderInterface::onStartEvent ");
+
+    if (!m_catalog)
+    {
+        LOG_ERROR("ReaderInterface: no playlist available");
+        return;
+    }
+
     m_requestedItemId = mediaId;
     start();
 }
 
 void ReaderInterface::onMediaRequest(unsigned mediaId)
 {
+    {
+        std::lock_guard<std::mutex> lock(m_seekMutex);
+        m_seekPosition.reset();
+    }
+
     m_requestedItemId = mediaId;
     LOG_INFO("ReaderInterface: Channel request successfully set to ", mediaId);
 }
 
+void ReaderInterface::onSeekEvent(double position)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_seekMutex);
+        m_seekPosition = position;
+    }
+
+    // Unblocks a pending read-ahead pop, the reader thread picks the request up on its next iteration
+    m_prefetcher.close();
+
+    LOG_INFO("ReaderInterface: seek request successfully set to ", position, "s");
+}
+
 void ReaderInterface::onStopEvent()
 {
     stop();
@@ -71,11 +153,17 @@ void ReaderInterface::onStopEvent()
     LOG_INFO("ReaderInterface::onStopEvent");
 }
 
+void ReaderInterface::onStop()
+{
+    // Unblocks a pending read-ahead pop so that the idle loop can exit
+    m_prefetcher.close();
+}
+
 void ReaderInterface::initialize()
 {
     m_t0 = m_timer.restart();
 
-    m_currentItemId = m_itemList.size();
+    m_currentItemId = m_catalog->getNumberOfItems();
 }
 
 void ReaderInterface::idle()
@@ -98,17 +186,58 @@ void ReaderInterface::updateItem()
     {
         m_currentItemId = m_requestedItemId;
 
-        m_itemList[m_currentItemId].reset();
+        m_prefetcher.close();
+        m_preloadedList.clear();
+
+        ItemPreloader::Entry entry;
+
+        if (m_preloader.take(m_currentItemId, entry))
+        {
+            // Resumes right after the preloaded segments, which are sent first
+            m_item = std::move(entry.item);
+            m_preloadedList = std::move(entry.segmentList);
+        }
+        else
+        {
+            m_item = m_catalog->getItem(m_currentItemId);
+            m_item.setMemoryMapping(m_memoryMapping);
+            m_item.setSegmentCache(m_segmentCache);
+            m_item.setSegmentIO(m_segmentIO);
+        }
+
+        if (m_preloader.isEnabled())
+        {
+            m_preloader.schedule(m_currentItemId);
+        }
+
+        if (m_prefetcher.isEnabled())
+        {
+            m_prefetcher.open(m_item);
+        }
 
-        m_delay.resize(m_itemList[m_currentItemId].getNumberOfStreams());
+        m_delay.resize(m_item.getNumberOfStreams());
         std::fill(m_delay.begin(), m_delay.end(), std::chrono::duration<double>{});
 
         m_t0 = m_timer.restart();
 
+        m_presentationDelay = m_lookAhead;
         m_checkpoint = std::chrono::duration<double>::zero();
         m_stop = false;
     }
 
+    // Seek if necessary
+    std::optional<double> seekPosition;
+
+    {
+        std::lock_guard<std::mutex> lock(m_seekMutex);
+        std::swap(seekPosition, m_seekPosition);
+    }
+
+    if (seekPosition)
+    {
+        seekItem(*seekPosition);
+    }
+
     if (m_stop)
     {
         return;
@@ -121,9 +250,25 @@ void ReaderInterface::updateItem()
     }
 
     // Send chunk
-    auto [streamId, chunck, duration] = m_itemList[m_currentItemId].next();
+    SegmentPrefetcher::Segment segment;
+
+    if (!m_preloadedList.empty())
+    {
+        segment = std::move(m_preloadedList.front());
+        m_preloadedList.pop_front();
+    }
+    else if (!m_prefetcher.isEnabled())
+    {
+        segment = m_item.next();
+    }
+    else if (!m_prefetcher.pop(segment))
+    {
+        return;
+    }
+
+    auto &[streamId, chunck, duration] = segment;
 
-    if (chunck.getData().empty())
+    if (chunck.empty())
     {
         if (m_decoderInterface != nullptr)
         {
@@ -137,7 +282,7 @@ void ReaderInterface::updateItem()
         return;
     }
 
-    if (!m_loop_stream && chunck.getHeader().getSegmentId() == m_itemList[m_currentItemId].getStreams()[streamId].getNumberOfSegments()-1)
+    if (!m_loop_stream && chunck.getHeader().getSegmentId() == m_item.getStreams()[streamId].getNumberOfSegments()-1)
     {
         m_stop = true;
     }
@@ -147,9 +292,9 @@ void ReaderInterface::updateItem()
         std::fill(m_delay.begin(), m_delay.end(), m_delay[0]);
     }
 
-    m_checkpoint = m_t0.time_since_epoch() + m_delay[streamId]; // at first iteration, m_delay[streamId] == 0. the next
-                                                                // segment will be bufferised without delay
-    auto pts = m_checkpoint + m_lookAhead;
+    // at first iteration, m_delay[streamId] == 0. the next segment will be bufferised without delay
+    auto pts = m_t0.time_since_epoch() + m_delay[streamId] + m_presentationDelay;
+    m_checkpoint = pts - m_lookAhead;
     m_delay[streamId] += duration;
 
     chunck.getHeader().setPTS(pts);
@@ -160,6 +305,94 @@ void ReaderInterface::updateItem()
     {
         m_decoderInterface->onChunkEvent(std::move(chunck));
     }
+
+    adaptLookAhead();
+}
+
+void ReaderInterface::adaptLookAhead()
+{
+    if (!m_decoderInterface || (m_lookAheadMin == m_lookAheadMax))
+    {
+        return;
+    }
+
+    auto margin = m_decoderInterface->getPresentationMargin();
+
+    if (std::isnan(margin))
+    {
+        return;
+    }
+
+    // Grows quickly when the decoded frames come close to their deadline, shrinks slowly when they are well ahead
+    auto lookAhead = std::chrono::duration<double>{m_lookAhead}.count();
+    auto target = m_lookAhead;
+
+    if (margin < 0.25 * lookAhead)
+    {
+        target = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::duration<double>{1.25 * lookAhead});
+    }
+    else if (0.75 * lookAhead < margin)
+    {
+        target = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::duration<double>{0.9 * lookAhead});
+    }
+
+    target = std::clamp(target, m_lookAheadMin, m_lookAheadMax);
+
+    if (target != m_lookAhead)
+    {
+        LOG_INFO("ReaderInterface: look-ahead set to ", target.count(), "ms (decoder margin ", margin, "s)");
+        m_lookAhead = target;
+    }
 }
 
-void ReaderInterface::finalize() { LOG_INFO("ReaderInterface::finalize"); }
+void ReaderInterface::seekItem(double position)
+{
+    m_prefetcher.close();
+    m_preloadedList.clear();
+
+    // Nothing sent before this point is presented anymore
+    if (m_decoderInterface)
+    {
+        m_decoderInterface->onSeekEvent();
+    }
+
+    auto origin = m_item.seek(position);
+
+    if (m_prefetcher.isEnabled())
+    {
+        m_prefetcher.open(m_item);
+    }
+
+    // Streams keep their relative offset, the earliest one is sent right away
+    for (std::size_t streamId = 0; streamId < m_delay.size(); streamId++)
+    {
+        m_delay[streamId] = std::chrono::duration<double>{m_item.getStreamDelay(streamId) - origin};
+    }
+
+    m_t0 = m_timer.restart();
+
+    m_presentationDelay = m_lookAhead;
+    m_checkpoint = std::chrono::duration<double>::zero();
+    m_stop = false;
+
+    LOG_INFO("ReaderInterface: seek to ", position, "s, resuming at ", origin, "s");
+}
+
+void ReaderInterface::finalize()
+{
+    m_prefetcher.close();
+    m_preloader.close();
+
+    if (m_segmentCache)
+    {
+        LOG_INFO("Segment cache: ",
+                 m_segmentCache->getHits(),
+                 " hit(s), ",
+                 m_segmentCache->getMisses(),
+                 " miss(es), ",
+                 m_segmentCache->getBytes(),
+                 " byte(s) in use");
+    }
+
+    LOG_INFO("ReaderInterface::finalize");
+}
@@ -9,12 +9,17 @@
 * See the License for the specific language governing permissions and limitations under the License.
 */
 
+#include <common/decoder/hevc.h>
 #include <common/decoder/miv.h>
+#include <common/decoder/package.h>
 #include <common/decoder/vpcc.h>
 #include <decoder/decoder.h>
 #include <iloj/gpu/framework/native/processor.h>
 #include <iloj/misc/dll.h>
 #include <iloj/misc/filesystem.h>
+#include <algorithm>
+#include <cmath>
+#include <thread>
 #include <iomanip>
 
 #if defined DASH_STREAMING || defined UVG_RTP_STREAMING
@@ -30,7 +35,78 @@ using namespace iloj::misc;
 using namespace iloj::media;
 using namespace iloj::gpu;
 
-std::array<std::unique_ptr<Processor>, VideoStream::Size> DecoderInterface::g_procVideoDecodingList;
+std::array<std::array<std::unique_ptr<Processor>, VideoStream::Size>, DecoderInterface::maxAtlasCount>
+    DecoderInterface::g_procVideoDecodingList;
+HANDLE DecoderInterface::g_sharedContext{};
+
+namespace
+{
+// Number of atlases of a frame, 2D and V-PCC content having a single one
+auto getAtlasCount(const GenericMetadata &metadata) -> std::size_t
+{
+    return (metadata.contentType == GenericMetadata::ContentType::MIV)
+               ? std::max<std::size_t>(metadata.MIVMetadata->atlas.size(), 1)
+               : 1;
+}
+
+// Video streams carried by atlas k of a frame, the texture of the first atlas being always expected
+auto getVideoStreamPresence(const GenericMetadata &metadata, std::size_t k) -> std::array<bool, VideoStream::Size>
+{
+    if (metadata.contentType == GenericMetadata::ContentType::VPCC)
+    {
+        return {true, true, true, false};
+    }
+
+    const auto &vps = metadata.MIVMetadata->vps;
+
+    bool hasAtlas = k < metadata.MIVMetadata->atlas.size();
+    auto atlasId = hasAtlas ? vps.vps_atlas_id(k) : TMIV::MivBitstream::AtlasId{};
+    auto attributeCount = hasAtlas ? vps.attribute_information(atlasId).ai_attribute_count() : 0;
+
+    return {hasAtlas && vps.vps_occupancy_video_present_flag(atlasId),
+            hasAtlas && vps.vps_geometry_video_present_flag(atlasId),
+            (k == 0) || (0 < attributeCount),
+            1 < attributeCount};
+}
+
+// Pushes a video sub-bitstream one access unit at a time, each stamped with the presentation timestamp of its picture
+// for the decoded frame to be paired with its metadata. The sub-bitstream goes whole and unstamped when its pictures
+// can not be told apart, its frames being then paired in order.
+void pushVideoData(AVCodec::Decoder &videoDecoder,
+                   Packet<Descriptor::Data> videoDataPkt,
+                   std::chrono::duration<double> pts,
+                   std::chrono::duration<double> frameDuration,
+                   std::uint32_t frameCount)
+{
+    const auto &frame = videoDataPkt->getFrame();
+    std::vector<hevc::AccessUnit> accessUnitList;
+
+    try
+    {
+        accessUnitList = hevc::splitAccessUnits({frame.data(), frame.size()});
+    }
+    catch (const std::runtime_error &)
+    {
+    }
+
+    if (accessUnitList.size() != frameCount)
+    {
+        videoDecoder.getStreamingInput().push(std::move(videoDataPkt));
+        return;
+    }
+
+    auto outputOrder = hevc::getOutputOrder(accessUnitList);
+
+    for (std::size_t auIdx = 0; auIdx < accessUnitList.size(); auIdx++)
+    {
+        const auto &accessUnit = accessUnitList[auIdx];
+
+        videoDecoder.getStreamingInput().push(make_packet<Descriptor::Data>(
+            Descriptor::Data::container_type{accessUnit.data.begin(), accessUnit.data.end()},
+            pts + static_cast<double>(outputOrder[auIdx]) * frameDuration));
+    }
+}
+} // namespace
 
 #ifdef __ANDROID__
 extern "C" JNIEXPORT jint JNI_OnLoad(JavaVM *vm, void * /* reserved */)
@@ -55,6 +131,34 @@ void DecoderInterface::onConfigure(const std::string &configFile)
         m_measureFPS = item.as<bool>();
     }
 
+    if (auto &item = json.getItem<JSON::Object>("Decoder").getItem("ParsingThreads"))
+    {
+        m_mivSession.setNumberOfThreads(item.as<unsigned>());
+        m_vpccNbThread = item.as<unsigned>();
+    }
+
+    if (auto &item = json.getItem<JSON::Object>("Decoder").getItem("ParsingWorkers"))
+    {
+        m_nbParsingWorker = item.as<unsigned>();
+    }
+
+    if (auto &item = json.getItem<JSON::Object>("Decoder").getItem("ParsingQueueDepth"))
+    {
+        m_parsingQueueDepth = item.as<unsigned>();
+    }
+
+    if (auto &item = json.getItem<JSON::Object>("Decoder").getItem("ChunkQueueSize"))
+    {
+        // Before any decoding starts, resizing is not thread safe
+        m_audioChunkQueue.resize(item.as<unsigned>());
+        m_videoChunkQueue.resize(item.as<unsigned>());
+    }
+
+    if (auto &item = json.getItem<JSON::Object>("Decoder").getItem("FrameAlignmentTolerance"))
+    {
+        m_frameAligner.setTolerance(std::chrono::duration<double, std::milli>{item.as<double>()});
+    }
+
     auto &jsonConfigList = json.getItem<JSON::Object>("Decoder").getItem<JSON::Array>("ConfigList");
     const auto nbConfig = jsonConfigList.getSize();
 
@@ -76,57 +180,40 @@ void DecoderInterface::onConfigure(const std::string &configFile)
         LOG_ERROR("AVCodec file undefined");
     }
 
-    const auto libraryPath = FileSystem::Path::getAbsolute(
-        {json.getItem<JSON::String>("Library").getValue(), FileSystem::Path{configFile}.getParent()});
-    if (!FileSystem::File{libraryPath}.exist())
+    if (!m_catalog)
     {
-        LOG_ERROR("Library file not found: ", libraryPath.toString());
+        LOG_ERROR("Playlist is empty or unreadable");
         return;
     }
+}
 
-    auto jsonLibrary = JSON::Object::fromFile(libraryPath.toString());
-    if (jsonLibrary.isEmpty())
-    {
-        LOG_ERROR("Library is unreadable");
-        return;
-    }
+void DecoderInterface::setSharedOpenGLContext(HANDLE hwContext)
+{
+    LOG_INFO("DecoderInterface::setSharedOpenGLContext");
 
-    const auto &jsonPlaylist = jsonLibrary.getItem<JSON::Array>("Playlist");
-    const auto nbChannel = jsonPlaylist.getSize();
-    if (!nbChannel)
+    if (m_glInteroperability && !g_procVideoDecodingList.front().front())
     {
-        LOG_ERROR("Playlist data is either missing or empty");
-        return;
-    }
+        // Kept for the processors of the other atlases, allocated along with their decoders
+        g_sharedContext = hwContext;
+        allocateVideoDecodingProcessors(0);
 
-    m_itemList = Item::makeItemList(jsonLibrary, nbChannel, true);
-    if (m_itemList.empty())
-    {
-        LOG_ERROR("Playlist is empty or unreadable");
-        return;
+        LOG_INFO("GL decoding processors allocated");
     }
 }
 
-void DecoderInterface::setSharedOpenGLContext(HANDLE hwContext)
+void DecoderInterface::allocateVideoDecodingProcessors(std::size_t atlasIdx)
 {
-    LOG_INFO("DecoderInterface::setSharedOpenGLContext");
-
-    if (m_glInteroperability && !g_procVideoDecodingList.front())
+    for (auto &procVideoDecoding : g_procVideoDecodingList[atlasIdx])
     {
-        for (auto &procVideoDecoding : g_procVideoDecodingList)
-        {
 #ifdef _WIN64
-            procVideoDecoding =
-                std::make_unique<framework::native::Processor>(reinterpret_cast<HGLRC>(hwContext), true);
+        procVideoDecoding =
+            std::make_unique<framework::native::Processor>(reinterpret_cast<HGLRC>(g_sharedContext), true);
 #elif defined __ANDROID__
-            procVideoDecoding =
-                std::make_unique<framework::native::Processor>(reinterpret_cast<EGLContext>(hwContext), true);
+        procVideoDecoding =
+            std::make_unique<framework::native::Processor>(reinterpret_cast<EGLContext>(g_sharedContext), true);
 #else
-            // TODO
+        // TODO
 #endif
-        }
-
-        LOG_INFO("GL decoding processors allocated");
     }
 }
 
@@ -134,14 +221,16 @@ void DecoderInterface::onStartEvent(unsigned mediaId)
 {
     LOG_INFO("DecoderInterface::onStartEvent");
 
+    // Before locking, opening joins the previous delivery thread, whose completion may be waiting for the lock
+    m_parserPool.open(m_nbParsingWorker, m_parsingQueueDepth);
+
     std::lock_guard<SpinLock> guard(m_locker);
     m_Tpkt = std::chrono::high_resolution_clock::now();
 
 #if defined DASH_STREAMING || defined UVG_RTP_STREAMING
-    if (( m_itemList[mediaId].getMode().compare("dash") == 0)
-        || (m_itemList[mediaId].getMode().compare("rtp") == 0)
-        || (m_itemList[mediaId].getMode().compare("webrtc") == 0)
-        )
+    const auto &mode = m_catalog->getMode(mediaId);
+
+    if ((mode.compare("dash") == 0) || (mode.compare("rtp") == 0) || (mode.compare("webrtc") == 0))
     {
         m_streamingMode = true;
     }
@@ -165,6 +254,13 @@ void DecoderInterface::onStartEvent(unsigned mediaId)
 
     m_hapticInitTime = std::chrono::duration<double>(0);
 
+    m_videoDiscardCount = 0;
+    m_audioDiscardCount = 0;
+    m_presentationMargin = std::numeric_limits<double>::quiet_NaN();
+
+    m_mivSession.reset();
+    m_mivSessionItemId = -1;
+
     m_requestedItemId = mediaId;
     start();
 }
@@ -172,8 +268,10 @@ void DecoderInterface::onStartEvent(unsigned mediaId)
 
 void DecoderInterface::onStopEvent()
 {
-    
-     std::lock_guard<SpinLock> guard(m_locker);
+    // Before locking, a completion being delivered may be waiting for the lock
+    m_parserPool.close();
+
+    std::lock_guard<SpinLock> guard(m_locker);
 
     //close inputs before calling stop.
     //when calling stop, onStop, idle and finalize are concurrent, so closing
@@ -183,8 +281,21 @@ void DecoderInterface::onStopEvent()
     for (auto &videoInput : m_videoInputList)
         videoInput.close();
 
+    for (auto &atlasDecoders : m_atlasDecodersList)
+    {
+        if (atlasDecoders)
+        {
+            for (auto &videoInput : atlasDecoders->videoInputList)
+                videoInput.close();
+        }
+    }
+
     stop();
 
+    // Once both the parser pool that pushes to them and the decoding thread that pops from them are stopped
+    m_audioChunkQueue.clear();
+    m_videoChunkQueue.clear();
+
     m_audioDecoder.reset();
 
     for (auto &videoDecoder : m_videoDecoderList)
@@ -192,14 +303,17 @@ void DecoderInterface::onStopEvent()
         videoDecoder.reset();
     }
 
+    for (auto &atlasDecoders : m_atlasDecodersList)
+    {
+        atlasDecoders.reset();
+    }
+
     LOG_INFO("DecoderInterface::onStopEvent");
 }
 
 
 void DecoderInterface::onChunkEvent(Chunk &&chunk)
 {
-    std::lock_guard<SpinLock> guard(m_locker);
-
     if (chunk.getHeader().getMediaId() == m_requestedItemId)
     {
         if (m_avcodec_name.empty())
@@ -214,20 +328,34 @@ void DecoderInterface::onChunkEvent(Chunk &&chunk)
 
         auto pkt = make_packet<Chunk>(std::move(chunk));
 
-        switch (pkt->getHeader().getTypeId())
+        // Parsed by the pool, then delivered to the decoders in chunk order
+        m_parserPool.submit([this, pkt]() { return parseChunk(pkt); });
+    }
+}
+
+auto DecoderInterface::parseChunk(Packet<Chunk> pkt) -> ParserPool::Completion
+{
+    switch (pkt->getHeader().getTypeId())
+    {
+        case Chunk::Header::TypeId::Audio:
         {
-            case Chunk::Header::TypeId::Audio:
+            return [this, pkt]() mutable
             {
+                std::lock_guard<SpinLock> guard(m_locker);
+
                 if (m_audioDecoder)
                 {
-                    for (std::uint32_t frameId = 0; frameId < pkt->getHeader().getNumberOfFrames(); frameId++)
+                    // in case of DASH, a frame is an m4s segment
+                    if (!m_audioChunkQueue.copy_push(pkt, pkt->getHeader().getNumberOfFrames()))
                     {
-                        //LOG_INFO("AUDIO: onChunkEvent push chunk in audioChunkQueue");
-                        // in case of DASH, a frame is an m4s segment
-                        m_audioChunkQueue.push(pkt);
+                        LOG_WARNING("Audio chunk queue full, chunk dropped (",
+                                    m_audioChunkQueue.getDropCount(),
+                                    " frame(s) so far)");
+                        return;
                     }
+
                     // push data in the streaming queue. to be decoded by AVCodec decoder
-                    m_audioDecoder->getStreamingInput().push(make_packet<Descriptor::Data>(std::move(pkt->getData())));
+                    m_audioDecoder->getStreamingInput().push(make_packet<Descriptor::Data>(pkt->releaseData()));
 
                     if (!m_audioDecoder->is_open())
                     {
@@ -244,26 +372,22 @@ void DecoderInterface::onChunkEvent(Chunk &&chunk)
                         }
                     }
                 }
-
-                break;
-            }
-            case Chunk::Header::TypeId::Hevc:
-            case Chunk::Header::TypeId::Vvc:
+            };
+        }
+        case Chunk::Header::TypeId::Hevc:
+        case Chunk::Header::TypeId::Vvc:
+        {
+            return [this, pkt]() mutable
             {
-                auto data_pkt = make_packet<Descriptor::Data>(std::move(pkt->getData()));
-                auto videoPkt = make_packet<GenericMetadata>(); //empty
+                auto data_pkt = make_packet<Descriptor::Data>(pkt->releaseData());
 
-                videoPkt->contentId = static_cast<int>(pkt->getHeader().getMediaId());
-                videoPkt->segmentId = static_cast<int>(pkt->getHeader().getSegmentId());
+                std::lock_guard<SpinLock> guard(m_locker);
 
-                if (m_videoDecoderList[VideoStream::Texture])
+                if (m_videoDecoderList[VideoStream::Texture] &&
+                    queueVideoFrames(pkt,
+                                     pkt->getHeader().getNumberOfFrames(),
+                                     [](std::uint32_t) { return make_packet<GenericMetadata>(); })) //empty
                 {
-                    for (std::uint32_t frameId = 0; frameId < pkt->getHeader().getNumberOfFrames(); frameId++)
-                    {
-                        m_videoChunkQueue.push(pkt);
-                        m_genericInput.push(videoPkt);
-                    }
-
                     m_videoDecoderList[VideoStream::Texture]->getStreamingInput().push(data_pkt);
                     if (!m_videoDecoderList[VideoStream::Texture]->is_open())
                     {
@@ -290,124 +414,170 @@ void DecoderInterface::onChunkEvent(Chunk &&chunk)
                         }
                     }
                 }
-
-                break;
-            }
-            case Chunk::Header::TypeId::Miv:
+            };
+        }
+        case Chunk::Header::TypeId::Miv:
+        {
+            // The MIV session carries the parameter sets from one segment to the next: it is decoded in chunk order
+            return [this, pkt]() mutable
             {
-                if (m_videoDecoderList[VideoStream::Texture])
+                if (m_mivSessionItemId != static_cast<int>(pkt->getHeader().getMediaId()))
                 {
-                    auto [mivAU, videoDataPktList] = miv::decodeMivBuffer(
-                        {reinterpret_cast<const char *>(pkt->getData().data()), pkt->getHeader().getDataSize()});
+                    m_mivSession.reset();
+                    m_mivSessionItemId = static_cast<int>(pkt->getHeader().getMediaId());
+                }
 
-                    auto mivPkt = make_packet<GenericMetadata>(mivAU);
+                // Packaged segments were demuxed offline
+                auto [mivAU, atlasDataPktList] =
+                    package::isPackage(pkt->data(), pkt->size())
+                        ? package::decodeMivPackage(pkt->data(), pkt->size(), m_mivSession)
+                        : m_mivSession.decode({pkt->data(), pkt->size()});
 
-                    if (mivPkt)
-                    {                        
-                        mivPkt->contentId = static_cast<int>(pkt->getHeader().getMediaId());
-                        mivPkt->segmentId = static_cast<int>(pkt->getHeader().getSegmentId());
-                        
+                if (maxAtlasCount < atlasDataPktList.size())
+                {
+                    LOG_ERROR("MIV segment with ", atlasDataPktList.size(), " atlases (at most ", maxAtlasCount,
+                              " supported)");
+                    return;
+                }
 
-                        for (std::uint32_t frameId = 0; frameId < pkt->getHeader().getNumberOfFrames(); frameId++)
-                        {
-                            m_videoChunkQueue.push(pkt);
-                            m_genericInput.push(mivPkt);
-                        }
+                std::lock_guard<SpinLock> guard(m_locker);
+
+                if (!m_videoDecoderList[VideoStream::Texture])
+                {
+                    return;
+                }
+
+                // Before queuing the metadata, which makes the decoding thread look for the atlas decoders
+                allocateAtlasDecoders(atlasDataPktList.size());
+
+                if (mivAU)
+                {
+                    // Before the chunk is queued, the decoding thread moving its timestamp along
+                    const auto &header = pkt->getHeader();
+                    auto pts = header.getPTS();
+                    auto frameDuration = header.getDuration() / std::max(header.getNumberOfFrames(), 1U);
+
+                    // One record for all the frames of the segment, the session keeping the shared metadata and the
+                    // renderer moving the frame order count of the copy along
+                    auto mivPkt = make_packet<GenericMetadata>(*mivAU);
 
+                    if (!queueVideoFrames(
+                            pkt, header.getNumberOfFrames(), [&mivPkt](std::uint32_t) { return mivPkt; }))
+                    {
+                        return;
+                    }
+
+                    // Each atlas has its own decoders, all of them running concurrently
+                    for (std::size_t atlasIdx = 0; atlasIdx < atlasDataPktList.size(); atlasIdx++)
+                    {
                         for (auto videoStreamId = 0; videoStreamId < VideoStream::Size; videoStreamId++)
                         {
-                            // NOTE: Decoding only first atlas
-                            if (videoDataPktList[videoStreamId])
+                            auto &videoDataPkt = atlasDataPktList[atlasIdx][videoStreamId];
+
+                            if (videoDataPkt)
                             {
-                                //m_dashInput[videoStreamId].push(std::move(videoDataPktList[videoStreamId]));
-                                m_videoDecoderList[videoStreamId]->getStreamingInput().push(
-                                    std::move(videoDataPktList[videoStreamId]));
+                                auto &videoDecoder = getVideoDecoder(atlasIdx, videoStreamId);
+
+                                pushVideoData(videoDecoder,
+                                              std::move(videoDataPkt),
+                                              pts,
+                                              frameDuration,
+                                              header.getNumberOfFrames());
 
-                                if (!m_videoDecoderList[videoStreamId]->is_open())
+                                if (!videoDecoder.is_open())
                                 {
                                     m_nbThread = m_configMap["miv"].m_nbThread;
                                     m_hardwareDecoding = m_configMap["miv"].m_hardwareDecoding;
                                     m_androidFormat = m_configMap["miv"].m_androidFormat;
-                                    m_videoDecoderList[videoStreamId]->open(
+                                    videoDecoder.open(
                                         "", { iloj::media::AVCodec::Decoder::Stream::BestVideo}, {10});
                                 }
                             }
                         }
                     }
                 }
-
-                break;
-            }
-            case Chunk::Header::TypeId::Vpcc:
+            };
+        }
+        case Chunk::Header::TypeId::Vpcc:
+        {
+            // V-PCC segments are self-contained: parsed on the worker
+            auto vpccData = pkt->releaseData();
+            auto [framesMetadata, videoDataPktList] =
+                package::isPackage(vpccData.data(), vpccData.size())
+                    ? package::decodeVpccPackage(vpccData.data(), vpccData.size())
+                    : decodeVpccBuffer({vpccData.data(), vpccData.size()}, m_vpccNbThread);
+
+            return [this,
+                    pkt,
+                    framesMetadata = std::move(framesMetadata),
+                    videoDataPktList = std::move(videoDataPktList)]() mutable
             {
-                if (m_videoDecoderList[VideoStream::Texture])
-                {
-                    auto [framesMetadata, videoDataPktList] =
-                        decodeVpccBuffer(const_cast<std::vector<uint8_t> &>(pkt->getData()));
+                std::lock_guard<SpinLock> guard(m_locker);
 
-                    if (!framesMetadata.empty())
-                    {
-                        //TODO streaming and reader really different ?
+                if (m_videoDecoderList[VideoStream::Texture] && !framesMetadata.empty())
+                {
+                    // Before the chunk is queued, the decoding thread moving its timestamp along
+                    const auto &header = pkt->getHeader();
+                    auto pts = header.getPTS();
+                    auto frameDuration = header.getDuration() / std::max(header.getNumberOfFrames(), 1U);
+                    auto makeMetadata = [&framesMetadata](std::uint32_t frameId)
+                    { return make_packet<GenericMetadata>(framesMetadata[frameId]); };
+
+                    //TODO streaming and reader really different ?
 #if defined DASH_STREAMING || defined UVG_RTP_STREAMING
-                        if (m_streamingMode)
+                    if (m_streamingMode)
+                    {
+                        if (!queueVideoFrames(pkt, static_cast<std::uint32_t>(framesMetadata.size()), makeMetadata))
                         {
-                            for (auto &metadata : framesMetadata)
-                            {
-                                auto vpccPkt = make_packet<GenericMetadata>(metadata);
-                                vpccPkt->contentId = static_cast<int>(pkt->getHeader().getMediaId());
-                                vpccPkt->segmentId = static_cast<int>(pkt->getHeader().getSegmentId());
-                                m_genericInput.push(vpccPkt);
-                                m_videoChunkQueue.push(pkt);
-                            }
+                            return;
                         }
-                        else
+                    }
+                    else
 #endif // STREAMING
+                    {
+                        // keep reader behaviour for now
+                        if (framesMetadata.size() == pkt->getHeader().getNumberOfFrames())
                         {
-                            // keep reader behaviour for now
-                            if (framesMetadata.size() == pkt->getHeader().getNumberOfFrames())
+                            // reader behaviour: as many as vpccpkt
+                            if (!queueVideoFrames(pkt, header.getNumberOfFrames(), makeMetadata))
                             {
-                                for (std::uint32_t frameId = 0; frameId < pkt->getHeader().getNumberOfFrames();
-                                     frameId++)
-                                {
-                                    auto vpccPkt = make_packet<GenericMetadata>(framesMetadata[frameId]);
-                                    vpccPkt->contentId = static_cast<int>(pkt->getHeader().getMediaId());
-                                    vpccPkt->segmentId = static_cast<int>(pkt->getHeader().getSegmentId());
-
-                                    m_genericInput.push(vpccPkt);
-                                    m_videoChunkQueue.push(pkt); // reader behaviour: as many as vpccpkt
-                                }
+                                return;
                             }
                         }
+                    }
 
-                        for (auto videoStreamId = 0; videoStreamId < VideoStream::Size; videoStreamId++)
+                    for (auto videoStreamId = 0; videoStreamId < VideoStream::Size; videoStreamId++)
+                    {
+                        // NOTE: Decoding only first atlas
+                        if (videoDataPktList[videoStreamId])
                         {
-                            // NOTE: Decoding only first atlas
-                            if (videoDataPktList[videoStreamId])
+                            //m_dashInput[videoStreamId].push(std::move(videoDataPktList[videoStreamId]));
+                            pushVideoData(*m_videoDecoderList[videoStreamId],
+                                          std::move(videoDataPktList[videoStreamId]),
+                                          pts,
+                                          frameDuration,
+                                          static_cast<std::uint32_t>(framesMetadata.size()));
+                            if (!m_videoDecoderList[videoStreamId]->is_open())
                             {
-                                //m_dashInput[videoStreamId].push(std::move(videoDataPktList[videoStreamId]));
-                                m_videoDecoderList[videoStreamId]->getStreamingInput().push(
-                                    std::move(videoDataPktList[videoStreamId]));
-                                if (!m_videoDecoderList[videoStreamId]->is_open())
-                                {
-                                    m_nbThread = m_configMap["vpcc"].m_nbThread;
-                                    m_hardwareDecoding = m_configMap["vpcc"].m_hardwareDecoding;
-                                    m_androidFormat = m_configMap["vpcc"].m_androidFormat;
+                                m_nbThread = m_configMap["vpcc"].m_nbThread;
+                                m_hardwareDecoding = m_configMap["vpcc"].m_hardwareDecoding;
+                                m_androidFormat = m_configMap["vpcc"].m_androidFormat;
 
-                                    m_videoDecoderList[videoStreamId]->open(
-                                        "", { iloj::media::AVCodec::Decoder::Stream::BestVideo}, {10});
-                                }
+                                m_videoDecoderList[videoStreamId]->open(
+                                    "", { iloj::media::AVCodec::Decoder::Stream::BestVideo}, {10});
                             }
                         }
-
-                        m_atlasFrameHeight = framesMetadata[0].frame_height;
-                        m_atlasFrameWidth = framesMetadata[0].frame_width;
-
                     }
-                }
 
-                break;
-            }
-            case Chunk::Header::TypeId::Haptic:
+                    m_atlasFrameHeight = framesMetadata[0].frame_height;
+                    m_atlasFrameWidth = framesMetadata[0].frame_width;
+                }
+            };
+        }
+        case Chunk::Header::TypeId::Haptic:
+        {
+            // The haptic decoder feeds its own input as it decodes, in chunk order
+            return [this, pkt]() mutable
             {
                 if (m_hapticDecoder && m_schedulerInterface)
                 {
@@ -424,8 +594,7 @@ void DecoderInterface::onChunkEvent(Chunk &&chunk)
                         m_hapticInitTime = pkt->getHeader().getPTS();
                         m_hapticDecoder->setHapticInput(m_schedulerInterface->getHapticInput());
 
-                        Chunk::Buffer &buf = pkt.getContent().getData();
-                        std::string s(buf.begin(), buf.end());
+                        std::string s(pkt->data(), pkt->data() + pkt->size());
 
                         onInit(m_hapticInitTime);
                         onDecode(s, m_hapticDecoder->getHapticInput());
@@ -436,13 +605,39 @@ void DecoderInterface::onChunkEvent(Chunk &&chunk)
                     }
 
                 }
-                break;
-            }
-            default:
-                LOG_WARNING("Unknown chunk type");
-                break;
+            };
         }
+        default:
+            LOG_WARNING("Unknown chunk type");
+            return {};
+    }
+}
+
+auto DecoderInterface::queueVideoFrames(const Packet<Chunk> &pkt,
+                                        std::uint32_t frameCount,
+                                        const std::function<Packet<GenericMetadata>(std::uint32_t)> &makeMetadata)
+    -> bool
+{
+    const auto &header = pkt->getHeader();
+
+    // The decoding thread reads the chunk of a frame once its metadata is there
+    if (!m_videoChunkQueue.copy_push(pkt, frameCount))
+    {
+        LOG_WARNING("Video chunk queue full, chunk dropped (", m_videoChunkQueue.getDropCount(), " frame(s) so far)");
+        return false;
+    }
+
+    for (std::uint32_t frameId = 0; frameId < frameCount; frameId++)
+    {
+        auto metadataPkt = makeMetadata(frameId);
+
+        metadataPkt->contentId = static_cast<int>(header.getMediaId());
+        metadataPkt->segmentId = static_cast<int>(header.getSegmentId());
+
+        m_genericInput.push(std::move(metadataPkt));
     }
+
+    return true;
 }
 
 void DecoderInterface::onMediaRequest(unsigned mediaId)
@@ -451,6 +646,32 @@ void DecoderInterface::onMediaRequest(unsigned mediaId)
     LOG_INFO("DecoderInterface: Channel request successfully set to ", mediaId);
 }
 
+void DecoderInterface::onSeekEvent()
+{
+    // The chunks received before the seek reach the queues first, to be discarded along with the others
+    m_parserPool.flush();
+
+    std::lock_guard<SpinLock> guard(m_locker);
+
+    // The codecs are not flushed, frames are paired with their chunk in order so the pending ones can be told apart
+    m_videoDiscardCount = m_videoChunkQueue.size();
+    m_audioDiscardCount = m_audioChunkQueue.size();
+    m_presentationMargin = std::numeric_limits<double>::quiet_NaN();
+
+    m_mivSession.reset();
+
+    if (m_schedulerInterface)
+    {
+        m_schedulerInterface->onSeekEvent();
+    }
+
+    LOG_INFO("DecoderInterface::onSeekEvent, dropping ",
+             m_videoDiscardCount,
+             " video frame(s) and ",
+             m_audioDiscardCount,
+             " audio frame(s)");
+}
+
 void DecoderInterface::onStart()
 {
 
@@ -479,28 +700,82 @@ void DecoderInterface::idle()
         auto isDASH2DContent = m_streamingMode && is2DContent;
 #endif // STREAMING
 
-        const auto &vps = genericPkt->MIVMetadata->vps;
-
-        bool hasAtlas = !genericPkt->MIVMetadata->atlas.empty();
-        auto atlasId = hasAtlas ? vps.vps_atlas_id(0) : TMIV::MivBitstream::AtlasId{};
-
-        bool hasOccupancy = genericPkt->contentType != GenericMetadata::ContentType::VPCC
-                                ? hasAtlas && vps.vps_occupancy_video_present_flag(atlasId)
-                                : true;
-        bool hasGeometry = genericPkt->contentType != GenericMetadata::ContentType::VPCC
-                               ? hasAtlas && vps.vps_geometry_video_present_flag(atlasId)
-                               : true;
-        bool hasTransparency = genericPkt->contentType != GenericMetadata::ContentType::VPCC
-                                   ? hasAtlas && (1 < vps.attribute_information(atlasId).ai_attribute_count())
-                                   : false;
-
-        bool is_video_ready = !(m_videoInputList[VideoStream::Texture].empty() ||
-                                (hasOccupancy && m_videoInputList[VideoStream::Occupancy].empty()) ||
-                                (hasGeometry && m_videoInputList[VideoStream::Geometry].empty()) ||
-                                (hasTransparency && m_videoInputList[VideoStream::Transparency].empty()));
+        // A frame is ready once every video stream of each of its atlases is
+        const auto atlasCount = getAtlasCount(genericPkt.getContent());
+        std::array<std::array<bool, VideoStream::Size>, maxAtlasCount> videoStreamPresenceList{};
+        std::array<VideoInput *, maxAtlasCount * VideoStream::Size> videoJoinList{};
+
+        for (std::size_t atlasIdx = 0; atlasIdx < atlasCount; atlasIdx++)
+        {
+            videoStreamPresenceList[atlasIdx] = getVideoStreamPresence(genericPkt.getContent(), atlasIdx);
+
+            for (auto videoStreamId = 0; videoStreamId < VideoStream::Size; videoStreamId++)
+            {
+                if (videoStreamPresenceList[atlasIdx][videoStreamId])
+                {
+                    auto k = atlasIdx * VideoStream::Size + videoStreamId;
+                    videoJoinList[k] = &getVideoInput(atlasIdx, videoStreamId);
+                }
+            }
+        }
+
+        // Sleeps on the decoder outputs, a timeout or a closed input leaving the frame for the next call
+        using JoinStatus = decltype(m_videoJoin)::Status;
+        bool is_video_ready = (m_videoJoin.join(videoJoinList, videoJoinTimeout) == JoinStatus::Ready);
+
+        // The streams of 2D content go without alignment, DASH reusing the metadata of a segment for all its frames.
+        // Streamed chunks are stamped when presented and frames discarded after a seek are paired in order.
+        auto isAlignable = (genericPkt->contentType != GenericMetadata::ContentType::Unknown);
+#if defined DASH_STREAMING || defined UVG_RTP_STREAMING
+        isAlignable = isAlignable && !m_streamingMode;
+#endif // STREAMING
+
+        if (is_video_ready && isAlignable && (m_videoDiscardCount == 0))
+        {
+            using AlignmentStatus = decltype(m_frameAligner)::Status;
+
+            // The chunk of the frame carries its presentation timestamp, moved along as its frames are presented
+            switch (m_frameAligner.align(videoJoinList, m_videoChunkQueue.front()->getHeader().getPTS()))
+            {
+                case AlignmentStatus::Aligned:
+                    break;
+                case AlignmentStatus::Pending:
+                    is_video_ready = false;
+                    break;
+                case AlignmentStatus::Orphan:
+                {
+                    // Skipped as if presented, the next frames of the chunk keeping their timestamp
+                    auto &header = m_videoChunkQueue.front()->getHeader();
+                    header.setPTS(header.getPTS() + header.getDuration() / std::max(header.getNumberOfFrames(), 1U));
+
+                    m_videoChunkQueue.pop();
+                    m_genericInput.pop();
+                    return;
+                }
+            }
+        }
+
         bool is_audio_ready = !(m_audioChunkQueue.empty());
 
-        if (is_video_ready)
+        if (is_video_ready && (0 < m_videoDiscardCount))
+        {
+            m_videoDiscardCount--;
+            m_videoChunkQueue.pop();
+
+            for (std::size_t atlasIdx = 0; atlasIdx < atlasCount; atlasIdx++)
+            {
+                for (auto videoStreamId = 0; videoStreamId < VideoStream::Size; videoStreamId++)
+                {
+                    if (videoStreamPresenceList[atlasIdx][videoStreamId])
+                    {
+                        getVideoInput(atlasIdx, videoStreamId).pop();
+                    }
+                }
+            }
+
+            m_genericInput.pop();
+        }
+        else if (is_video_ready)
         {
             std::array<VideoPacket, VideoStream::Size> videoPacketList;
             {
@@ -557,6 +832,12 @@ void DecoderInterface::idle()
                     pts = header.getPTS();
                     auto duration = header.getDuration() / header.getNumberOfFrames();
                     header.setPTS(pts + duration);
+
+                    // Follows drops immediately and recoveries slowly
+                    auto margin = (pts - std::chrono::system_clock::now().time_since_epoch()).count();
+                    double current = m_presentationMargin;
+                    m_presentationMargin =
+                        (std::isnan(current) || margin < current) ? margin : current + 0.05 * (margin - current);
                 }
 
                 videoPacketList[VideoStream::Texture] = m_videoInputList[VideoStream::Texture].front();
@@ -574,27 +855,36 @@ void DecoderInterface::idle()
                 m_videoInputList[VideoStream::Texture].pop();
             }
 
-            if (hasOccupancy)
+            for (auto videoStreamId = 0; videoStreamId < VideoStream::Size; videoStreamId++)
             {
-                videoPacketList[VideoStream::Occupancy] = m_videoInputList[VideoStream::Occupancy].front();
-                m_videoInputList[VideoStream::Occupancy].pop();
+                if ((videoStreamId != VideoStream::Texture) && videoStreamPresenceList[0][videoStreamId])
+                {
+                    videoPacketList[videoStreamId] = m_videoInputList[videoStreamId].front();
+                    m_videoInputList[videoStreamId].pop();
+                }
             }
 
-            if (hasGeometry)
-            {
-                videoPacketList[VideoStream::Geometry] = m_videoInputList[VideoStream::Geometry].front();
-                m_videoInputList[VideoStream::Geometry].pop();
-            }
+            // The other atlases go along with the first one
+            std::vector<std::array<VideoPacket, VideoStream::Size>> atlasVideoPacketList(atlasCount - 1);
 
-            if (hasTransparency)
+            for (std::size_t atlasIdx = 1; atlasIdx < atlasCount; atlasIdx++)
             {
-                videoPacketList[VideoStream::Transparency] = m_videoInputList[VideoStream::Transparency].front();
-                m_videoInputList[VideoStream::Transparency].pop();
+                for (auto videoStreamId = 0; videoStreamId < VideoStream::Size; videoStreamId++)
+                {
+                    if (videoStreamPresenceList[atlasIdx][videoStreamId])
+                    {
+                        auto &videoInput = getVideoInput(atlasIdx, videoStreamId);
+
+                        atlasVideoPacketList[atlasIdx - 1][videoStreamId] = videoInput.front();
+                        videoInput.pop();
+                    }
+                }
             }
 
             if (m_schedulerInterface)
             {
-                DecodedVideoData data = {std::move(genericPkt), std::move(videoPacketList)};
+                DecodedVideoData data = {
+                    std::move(genericPkt), std::move(videoPacketList), std::move(atlasVideoPacketList)};
                 m_schedulerInterface->getVideoInput().push(make_packet<DecodedVideoData>(std::move(data)));
 
 #if defined DASH_STREAMING || defined UVG_RTP_STREAMING
@@ -633,10 +923,6 @@ void DecoderInterface::idle()
             }
         }
 #endif
-        else
-        {
-            std::this_thread::sleep_for(std::chrono::microseconds{100});
-        }
     }
 }
 
@@ -669,6 +955,13 @@ void DecoderInterface::allocateAudioDecoder(std::string avcodec_name)
                     {
                         //LOG_INFO("AUDIO: m_audioChunkQueue empty");
                     }
+                    else if (0 < m_audioDiscardCount)
+                    {
+                        // Stamped before any seek, so that the scheduler drops it
+                        m_audioDiscardCount--;
+                        desc.getMetadata().setTimeStamp(std::chrono::duration<double>::zero());
+                        m_audioChunkQueue.pop();
+                    }
                     else
                     {
                         std::chrono::duration<double> pts;
@@ -724,25 +1017,82 @@ void DecoderInterface::allocateVideoDecoders(std::string avcodec_name)
     // VideoStream: Occupancy, Geometry, Texture, Transparency
     for (auto videoStreamId = 0; videoStreamId < VideoStream::Size; videoStreamId++)
     {
-        m_videoDecoderList[videoStreamId] = std::make_unique<iloj::media::AVCodec::Decoder>();
-        m_videoDecoderList[videoStreamId]->init(avcodec_name);
+        m_videoDecoderList[videoStreamId] = makeVideoDecoder(0, videoStreamId, avcodec_name);
+    }
+}
+
+void DecoderInterface::allocateAtlasDecoders(std::size_t atlasCount)
+{
+    for (std::size_t atlasIdx = 1; atlasIdx < atlasCount; atlasIdx++)
+    {
+        auto &atlasDecoders = m_atlasDecodersList[atlasIdx - 1];
 
-        m_videoDecoderList[videoStreamId]->setOnOpeningFunction(
-            [this, videoStreamId]()
-            {
-                // Connection to internal input
-                connect(m_videoDecoderList[videoStreamId]->getVideoOutput(0, m_nbThread, m_hardwareDecoding, m_androidFormat, *g_procVideoDecodingList[videoStreamId]), m_videoInputList[videoStreamId]);
+        if (atlasDecoders)
+        {
+            continue;
+        }
+
+        if (m_glInteroperability && g_sharedContext && !g_procVideoDecodingList[atlasIdx].front())
+        {
+            allocateVideoDecodingProcessors(atlasIdx);
+        }
 
-                LOG_INFO(miv::getVideoStreamName(videoStreamId), " stream opened");
+        auto decoders = std::make_unique<AtlasDecoders>();
 
-                // Starting
-                m_videoDecoderList[videoStreamId]->start();
+        for (auto videoStreamId = 0; videoStreamId < VideoStream::Size; videoStreamId++)
+        {
+            decoders->videoInputList[videoStreamId].open();
+            decoders->videoDecoderList[videoStreamId] = makeVideoDecoder(atlasIdx, videoStreamId, m_avcodec_name);
+        }
+
+        atlasDecoders = std::move(decoders);
 
-                LOG_INFO(miv::getVideoStreamName(videoStreamId), " decoder started");
-            });
+        LOG_INFO("Video decoders of atlas #", atlasIdx, " allocated");
     }
 }
 
+auto DecoderInterface::makeVideoDecoder(std::size_t atlasIdx, int videoStreamId, const std::string &avcodec_name)
+    -> std::unique_ptr<iloj::media::AVCodec::Decoder>
+{
+    auto videoDecoder = std::make_unique<iloj::media::AVCodec::Decoder>();
+    videoDecoder->init(avcodec_name);
+
+    videoDecoder->setOnOpeningFunction(
+        [this, atlasIdx, videoStreamId]()
+        {
+            auto &decoder = getVideoDecoder(atlasIdx, videoStreamId);
+
+            // Connection to internal input
+            connect(decoder.getVideoOutput(0,
+                                           m_nbThread,
+                                           m_hardwareDecoding,
+                                           m_androidFormat,
+                                           *g_procVideoDecodingList[atlasIdx][videoStreamId]),
+                    getVideoInput(atlasIdx, videoStreamId));
+
+            LOG_INFO(miv::getVideoStreamName(videoStreamId), " stream opened (atlas #", atlasIdx, ")");
+
+            // Starting
+            decoder.start();
+
+            LOG_INFO(miv::getVideoStreamName(videoStreamId), " decoder started (atlas #", atlasIdx, ")");
+        });
+
+    return videoDecoder;
+}
+
+auto DecoderInterface::getVideoDecoder(std::size_t atlasIdx, int videoStreamId) -> iloj::media::AVCodec::Decoder &
+{
+    return (atlasIdx == 0) ? *m_videoDecoderList[videoStreamId]
+                           : *m_atlasDecodersList[atlasIdx - 1]->videoDecoderList[videoStreamId];
+}
+
+auto DecoderInterface::getVideoInput(std::size_t atlasIdx, int videoStreamId) -> VideoInput &
+{
+    return (atlasIdx == 0) ? m_videoInputList[videoStreamId]
+                           : m_atlasDecodersList[atlasIdx - 1]->videoInputList[videoStreamId];
+}
+
 void DecoderInterface::stopDecoders()
 {
     // finish is not blocking and asks the decoders to end their execution loop
@@ -751,6 +1101,14 @@ void DecoderInterface::stopDecoders()
     m_audioDecoder->finish();
     for (auto &dec : m_videoDecoderList)
         dec->finish();
+    for (auto &atlasDecoders : m_atlasDecodersList)
+    {
+        if (atlasDecoders)
+        {
+            for (auto &dec : atlasDecoders->videoDecoderList)
+                dec->finish();
+        }
+    }
     stopHapticDecoder();
     stopAudioDecoder();
     stopVideoDecoders();
@@ -767,10 +1125,13 @@ void DecoderInterface::stopAudioDecoder()
     m_audioDecoder->stop();
     m_audioDecoder->exit();
 
-    LOG_INFO("Audio queue size: ", m_audioChunkQueue.size());
+    LOG_INFO("Audio queue size: ",
+             m_audioChunkQueue.size(),
+             ", peak: ",
+             m_audioChunkQueue.getMaxOccupancy(),
+             ", dropped: ",
+             m_audioChunkQueue.getDropCount());
     LOG_INFO("Audio decoder stopped");
-
-    m_audioChunkQueue = {};
 }
 
 void DecoderInterface::stopVideoDecoders()
@@ -788,9 +1149,72 @@ void DecoderInterface::stopVideoDecoders()
         LOG_INFO(miv::getVideoStreamName(videoStreamId), " decoder stopped");
     }
 
-    LOG_INFO("Video queue size: ", m_videoChunkQueue.size());
-    LOG_INFO("Video decoders stopped");
+    for (auto &atlasDecoders : m_atlasDecodersList)
+    {
+        if (atlasDecoders)
+        {
+            for (auto videoStreamId = 0; videoStreamId < VideoStream::Size; videoStreamId++)
+            {
+                atlasDecoders->videoInputList[videoStreamId].clear();
+                atlasDecoders->videoDecoderList[videoStreamId]->stop();
+                atlasDecoders->videoDecoderList[videoStreamId]->exit();
+            }
+        }
+    }
+
+    LOG_INFO("Video queue size: ",
+             m_videoChunkQueue.size(),
+             ", peak: ",
+             m_videoChunkQueue.getMaxOccupancy(),
+             ", dropped: ",
+             m_videoChunkQueue.getDropCount());
+    LOG_INFO("Video frames joined: ", m_videoJoin.getJoinCount(), ", timeouts: ", m_videoJoin.getTimeoutCount());
+
+    for (std::size_t atlasIdx = 0; atlasIdx < maxAtlasCount; atlasIdx++)
+    {
+        for (auto videoStreamId = 0; videoStreamId < VideoStream::Size; videoStreamId++)
+        {
+            auto k = atlasIdx * VideoStream::Size + videoStreamId;
+
+            if (0 < m_videoJoin.getWaitTime(k).count())
+            {
+                LOG_INFO("Atlas ",
+                         atlasIdx,
+                         " ",
+                         miv::getVideoStreamName(videoStreamId),
+                         " waited for: ",
+                         std::chrono::duration_cast<std::chrono::milliseconds>(m_videoJoin.getWaitTime(k)).count(),
+                         " ms, last of ",
+                         m_videoJoin.getLastCount(k),
+                         " frame(s)");
+            }
+        }
+    }
+
+    m_videoJoin.reset();
+
+    LOG_INFO("Frame metadata without decoded frames: ", m_frameAligner.getOrphanMetadataCount());
+
+    for (std::size_t atlasIdx = 0; atlasIdx < maxAtlasCount; atlasIdx++)
+    {
+        for (auto videoStreamId = 0; videoStreamId < VideoStream::Size; videoStreamId++)
+        {
+            auto k = atlasIdx * VideoStream::Size + videoStreamId;
 
-    m_videoChunkQueue = {};
+            if (0 < m_frameAligner.getOrphanFrameCount(k))
+            {
+                LOG_INFO("Atlas ",
+                         atlasIdx,
+                         " ",
+                         miv::getVideoStreamName(videoStreamId),
+                         " stale frame(s) discarded: ",
+                         m_frameAligner.getOrphanFrameCount(k));
+            }
+        }
+    }
+
+    m_frameAligner.reset();
+
+    LOG_INFO("Video decoders stopped");
 }
 
@@ -0,0 +1,176 @@
+/*
+* Copyright (c) 2025 InterDigital CE Patent Holdings SASU
+* Licensed under the License terms of 5GMAG software (the "License").
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at https://www.5g-mag.com/license .
+* Unless required by applicable law or agreed to in writing, software distributed under the License is
+* distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and limitations under the License.
+*/
+
+#include <algorithm>
+#include <decoder/parser_pool.h>
+#include <iloj/misc/logger.h>
+
+void ParserPool::open(unsigned nbWorker, std::size_t maxPending)
+{
+    std::lock_guard<std::mutex> control(m_control);
+
+    shutdown();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_maxPending = std::max<std::size_t>(maxPending, 1);
+        m_closing = false;
+    }
+
+    m_workerList.resize(std::max(nbWorker, 1U));
+
+    for (auto &worker : m_workerList)
+    {
+        worker = std::make_unique<Worker>(*this);
+        worker->setServiceName(L"ParserPool::Worker");
+        worker->start();
+    }
+
+    setServiceName(L"ParserPool");
+    start();
+}
+
+void ParserPool::close()
+{
+    std::lock_guard<std::mutex> control(m_control);
+
+    shutdown();
+}
+
+void ParserPool::shutdown()
+{
+    onStop();
+
+    for (auto &worker : m_workerList)
+    {
+        worker->stop();
+    }
+
+    m_workerList.clear();
+    stop();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_jobQueue.clear();
+    m_completionMap.clear();
+    m_deliveryId = m_submitId;
+}
+
+auto ParserPool::submit(Job job) -> bool
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    m_cond.wait(lock, [this]() { return m_closing || (m_submitId - m_deliveryId < m_maxPending); });
+
+    if (m_closing)
+    {
+        return false;
+    }
+
+    m_jobQueue.emplace_back(m_submitId++, std::move(job));
+    m_cond.notify_all();
+
+    return true;
+}
+
+void ParserPool::flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    m_cond.wait(lock, [this]() { return m_closing || (m_deliveryId == m_submitId); });
+}
+
+auto ParserPool::runJob() -> bool
+{
+    std::pair<std::uint64_t, Job> job;
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        m_cond.wait(lock, [this]() { return m_closing || !m_jobQueue.empty(); });
+
+        if (m_closing)
+        {
+            return false;
+        }
+
+        job = std::move(m_jobQueue.front());
+        m_jobQueue.pop_front();
+    }
+
+    // A failed job still takes its turn at delivery, with nothing to deliver
+    Completion completion;
+
+    try
+    {
+        completion = job.second();
+    }
+    catch (std::exception &e)
+    {
+        LOG_ERROR("ParserPool: ", e.what());
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!m_closing)
+    {
+        m_completionMap.emplace(job.first, std::move(completion));
+        m_cond.notify_all();
+    }
+
+    return true;
+}
+
+void ParserPool::idle()
+{
+    Completion completion;
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        m_cond.wait(lock, [this]() { return m_closing || (m_completionMap.count(m_deliveryId) != 0); });
+
+        // Left until stop joins the thread
+        if (m_closing)
+        {
+            finish();
+            return;
+        }
+
+        auto iter = m_completionMap.find(m_deliveryId);
+        completion = std::move(iter->second);
+        m_completionMap.erase(iter);
+    }
+
+    try
+    {
+        if (completion)
+        {
+            completion();
+        }
+    }
+    catch (std::exception &e)
+    {
+        LOG_ERROR("ParserPool: ", e.what());
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Counted once run, so that flush returns with every completion done
+    m_deliveryId++;
+    m_cond.notify_all();
+}
+
+void ParserPool::onStop()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_closing = true;
+    m_cond.notify_all();
+}
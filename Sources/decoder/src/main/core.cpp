@@ -232,6 +232,14 @@ extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API OnStopEvent()
     }
 }
 
+extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API OnSeekEvent(double position)
+{
+    if (g_interface)
+    {
+        g_interface->onSeekEvent(position);
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Errors handling
 extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API SetOnErrorEventCallback(OnErrorEventCallback ec)
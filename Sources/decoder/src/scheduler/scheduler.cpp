@@ -19,11 +19,18 @@ using namespace iloj::misc;
 std::chrono::duration<double> SchedulerInterface::MasterClock::now()
 {
     std::chrono::duration<double> out = std::chrono::system_clock::now().time_since_epoch();
-    if (m_forceDecodersSynchro) out = out - m_offset;
+    if (m_forceDecodersSynchro) out = out - std::chrono::duration<double>{m_offset};
     return out;
 }
 
-void SchedulerInterface::MasterClock::updateOffset(std::chrono::milliseconds offset) { m_offset += offset;}
+void SchedulerInterface::MasterClock::updateOffset(std::chrono::milliseconds offset)
+{
+    // Each scheduler moves the offset along from its own thread
+    auto current = m_offset.load();
+    while (!m_offset.compare_exchange_weak(current, current + std::chrono::duration<double>{offset}.count()))
+    {
+    }
+}
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 void SchedulerInterface::AudioScheduler::initialize()
@@ -59,6 +66,14 @@ void SchedulerInterface::AudioScheduler::idle()
         {
            
             const auto &desc = m_input.front().getContent();
+
+            if (0 < m_discardCount)
+            {
+                m_discardCount--;
+                m_input.pop();
+                return;
+            }
+
             auto dt = std::chrono::duration_cast<std::chrono::milliseconds>(desc.getMetadata().getTimeStamp()- m_masterClock->now());
 
             if (dt.count() < 0)
@@ -108,6 +123,14 @@ void SchedulerInterface::VideoScheduler::idle()
                 std::chrono::system_clock::now().time_since_epoch());*/
 
             auto pts = desc.videoPacketList[VideoStream::Texture]->getMetadata().getTimeStamp();
+
+            if (0 < m_discardCount)
+            {
+                m_discardCount--;
+                m_input.pop();
+                return;
+            }
+
             //std::chrono::duration<double> now = std::chrono::system_clock::now().time_since_epoch();
             std::chrono::duration<double> now = m_masterClock->now();
 
@@ -158,6 +181,14 @@ void SchedulerInterface::HapticScheduler::idle()
             const auto &desc = m_input.front().getContent();
 
             auto pts = desc.getStartTimeStamp(); /*-m_latency;*/
+
+            if (0 < m_discardCount)
+            {
+                m_discardCount--;
+                m_input.pop();
+                return;
+            }
+
             std::chrono::duration<double> now = m_masterClock->now(); 
             // std::chrono::system_clock::now().time_since_epoch();
 
@@ -254,3 +285,15 @@ void SchedulerInterface::onStopEvent()
 
     LOG_INFO("SchedulerInterface::onStopEvent");
 }
+
+void SchedulerInterface::onSeekEvent()
+{
+    // The inputs are only popped by their own service, so the pending samples are counted and dropped there
+    m_masterClock.flush();
+
+    m_audioScheduler.flush();
+    m_videoScheduler.flush();
+    m_hapticScheduler.flush();
+
+    LOG_INFO("SchedulerInterface::onSeekEvent");
+}
@@ -144,7 +144,7 @@ void NetworkInterface::updateStreamData(unsigned int mediaId)
     m_currentMediaId = mediaId;
 
 #if defined DASH_STREAMING
-    if (m_itemList[mediaId].getMode().compare("dash") == 0)
+    if (m_catalog->getMode(mediaId).compare("dash") == 0)
     {
         LOG_INFO("update Network settings for DASH ... ");
         const auto& stream = getItemStream(m_currentMediaId);
@@ -155,7 +155,7 @@ void NetworkInterface::updateStreamData(unsigned int mediaId)
     }
 #endif
 #if defined UVG_RTP_STREAMING
-    if (m_itemList[mediaId].getMode().compare("rtp") == 0)
+    if (m_catalog->getMode(mediaId).compare("rtp") == 0)
     {
         LOG_INFO("Update Network settings for UVG RTP ... ");
         const auto& stream = getItemStream(m_currentMediaId);
@@ -165,7 +165,7 @@ void NetworkInterface::updateStreamData(unsigned int mediaId)
     }
 #endif
 #if defined WEBRTC_RTP_STREAMING
-    if (m_itemList[mediaId].getMode().compare("webrtc") == 0)
+    if (m_catalog->getMode(mediaId).compare("webrtc") == 0)
     {
         LOG_INFO("Update Network settings for WebRTC RTP ... ");
         //TODO
@@ -273,34 +273,12 @@ void NetworkInterface::onConfigure(const std::string& configFile)
             return;
         }
 
-        const auto libraryPath = FileSystem::Path::getAbsolute(
-            { jsonConfig.getItem<JSON::String>("Library").getValue(), FileSystem::Path{configFile}.getParent() });
-        if (!FileSystem::File{ libraryPath }.exist()) {
-            LOG_ERROR("Library file not found: ", libraryPath.toString());
-            return;
-        }
-
-        auto jsonLibrary = JSON::Object::fromFile(libraryPath.toString());
-        if (jsonLibrary.isEmpty()) {
-            LOG_ERROR("Library is unreadable");
-            return;
-        }
-
-        const auto& jsonPlaylist = jsonLibrary.getItem<JSON::Array>("Playlist");
-        const auto nbChannel = jsonPlaylist.getSize();
-        if (!nbChannel) {
-            LOG_ERROR("Playlist data is either missing or empty");
-            return;
-        }
-
-        m_itemList = Item::makeItemList(jsonLibrary, nbChannel, true);
-        if (m_itemList.empty()) {
+        if (!m_catalog) {
             LOG_ERROR("Playlist is empty or unreadable");
             return;
         }
 
-        for (auto& item : m_itemList)
-            m_mediaList.emplace_back(item.getName());
+        m_mediaList = m_catalog->getNameList();
         m_bufferCapacity = std::max(3, jsonNetworking.getItem<JSON::Integer>("SegmentsBufferCapacity").getValue());
     }
     else
@@ -316,28 +294,7 @@ void NetworkInterface::onConfigure(const std::string& configFile)
             LOG_ERROR("No available sender information in config file");
             return;
         }
-        const auto libraryPath = FileSystem::Path::getAbsolute(
-            { jsonConfig.getItem<JSON::String>("Library").getValue(), FileSystem::Path{configFile}.getParent() });
-        if (!FileSystem::File{ libraryPath }.exist()) {
-            LOG_ERROR("Library file not found: ", libraryPath.toString());
-            return;
-        }
-
-        auto jsonLibrary = JSON::Object::fromFile(libraryPath.toString());
-        if (jsonLibrary.isEmpty()) {
-            LOG_ERROR("Library is unreadable");
-            return;
-        }
-
-        const auto& jsonPlaylist = jsonLibrary.getItem<JSON::Array>("Playlist");
-        const auto nbChannel = jsonPlaylist.getSize();
-        if (!nbChannel) {
-            LOG_ERROR("Playlist data is either missing or empty");
-            return;
-        }
-
-        m_itemList = Item::makeItemList(jsonLibrary, nbChannel, true);
-        if (m_itemList.empty()) {
+        if (!m_catalog) {
             LOG_ERROR("Playlist is empty or unreadable");
             return;
         }
@@ -352,7 +309,7 @@ void NetworkInterface::onStartEvent(unsigned mediaId)
     bool dllLoaded = false;
 
 #if defined DASH_STREAMING
-    if (m_itemList[mediaId].getMode().compare("dash") == 0)
+    if (m_catalog->getMode(mediaId).compare("dash") == 0)
     {
         LOG_INFO("Load V3C DASH Streamer dll ... ");
         dllLoaded = m_dashSegmentReceiver.loadDll();
@@ -363,7 +320,7 @@ void NetworkInterface::onStartEvent(unsigned mediaId)
     }
 #endif
 #if defined UVG_RTP_STREAMING
-    if (m_itemList[mediaId].getMode().compare("rtp") == 0)
+    if (m_catalog->getMode(mediaId).compare("rtp") == 0)
     {
         LOG_INFO("Load UVG RTP dll ... ");
         dllLoaded = m_rtpPacketReceiver.loadDll();
@@ -371,7 +328,7 @@ void NetworkInterface::onStartEvent(unsigned mediaId)
     }
 #endif
 #if defined WEBRTC_RTP_STREAMING
-    if (m_itemList[mediaId].getMode().compare("webrtc") == 0)
+    if (m_catalog->getMode(mediaId).compare("webrtc") == 0)
     {
         LOG_INFO("Load WebRTC RTP dll ... ");
         //TODO
@@ -429,6 +386,12 @@ void NetworkInterface::onMediaRequest(unsigned mediaId)
 #endif
 }
 
+void NetworkInterface::onSeekEvent(double position)
+{
+    // Live sessions have no random access, the position would have to be requested from the sender
+    LOG_WARNING("NetworkInterface: seeking to ", position, "s is not supported in remote mode");
+}
+
 void NetworkInterface::initialize()
 {
     LOG_INFO("NetworkInterface::initialize");
@@ -0,0 +1,187 @@
+/*
+* Copyright (c) 2025 InterDigital CE Patent Holdings SASU
+* Licensed under the License terms of 5GMAG software (the "License").
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at https://www.5g-mag.com/license .
+* Unless required by applicable law or agreed to in writing, software distributed under the License is
+* distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and limitations under the License.
+*/
+
+#include <common/decoder/miv.h>
+#include <common/decoder/package.h>
+#include <common/decoder/vpcc.h>
+#include <common/stream/chunk.h>
+#include <fstream>
+#include <iloj/media/avcodec.h>
+#include <iloj/misc/filesystem.h>
+#include <iloj/misc/string.h>
+#include <iostream>
+
+using namespace iloj::misc;
+using namespace iloj::media;
+
+namespace
+{
+void printUsage()
+{
+    std::cout << "Usage: V3CImmersivePackager <miv|vpcc> <input> <output> [nbSegment]\n"
+                 "  Writes the pre-demuxed package of a MIV / V-PCC segment.\n"
+                 "  With nbSegment, input and output are printf patterns (e.g. segment_%03d.bin) as in the\n"
+                 "  playlist, and segments 0 to nbSegment - 1 are packaged. The packaged segments replace the\n"
+                 "  original ones in the playlist (same Type, Path pointing to the output).\n";
+}
+
+// Same count as the reader does on unpackaged segments, so that both play identically
+auto getNumberOfFrames(const DataPacket &textureDataPacket) -> std::uint32_t
+{
+    AVCodec::Decoder decoder;
+
+    decoder.getStreamingInput().push(textureDataPacket);
+    decoder.getStreamingInput().push(Packet<Descriptor::Data>{});
+
+    decoder.open("", {AVCodec::Decoder::Stream::BestVideo});
+    auto info = decoder.getInformation().getItem<JSON::Array>("Streams").getItem<JSON::Object>(0);
+
+    return info.getItem("NbFrame").as<std::uint32_t>();
+}
+
+auto makeSegment(std::uint8_t typeId, std::vector<std::uint8_t> inputData) -> package::Segment
+{
+    package::Segment segment;
+
+    segment.typeId = typeId;
+
+    if (typeId == Chunk::Header::TypeId::Miv)
+    {
+        auto [au, atlasDataPacketList] = miv::decodeMivBuffer({inputData.data(), inputData.size()});
+
+        if (!au)
+        {
+            throw std::runtime_error("Invalid MIV segment");
+        }
+
+        // The package layout holds the video sub-bitstreams of one atlas
+        if (atlasDataPacketList.size() != 1)
+        {
+            throw std::runtime_error("Multi-atlas MIV segments cannot be packaged");
+        }
+
+        auto &videoDataPacketList = atlasDataPacketList.front();
+
+        if (!au->vui || !videoDataPacketList[VideoStream::Texture])
+        {
+            throw std::runtime_error("MIV segment without VUI or texture");
+        }
+
+        auto frameRate = static_cast<double>(au->vui->vui_time_scale()) / au->vui->vui_num_units_in_tick();
+
+        segment.nbFrame = getNumberOfFrames(videoDataPacketList[VideoStream::Texture]);
+        segment.duration = segment.nbFrame / frameRate;
+        segment.videoDataPacketList = std::move(videoDataPacketList);
+        segment.mivMetadata = miv::extractMivMetadata({inputData.data(), inputData.size()});
+    }
+    else
+    {
+        auto [framesMetadata, videoDataPacketList] = decodeVpccBuffer({inputData.data(), inputData.size()});
+
+        if (framesMetadata.empty() || !videoDataPacketList[VideoStream::Texture])
+        {
+            throw std::runtime_error("V-PCC segment without patch or texture");
+        }
+
+        // Frame rate assumed by the reader for V-PCC content
+        auto frameRate = 30.0;
+
+        segment.nbFrame = getNumberOfFrames(videoDataPacketList[VideoStream::Texture]);
+        segment.duration = segment.nbFrame / frameRate;
+        segment.videoDataPacketList = std::move(videoDataPacketList);
+        segment.vpccMetadata = std::move(framesMetadata);
+    }
+
+    return segment;
+}
+
+auto packageFile(std::uint8_t typeId, const std::string &inputPath, const std::string &outputPath) -> bool
+{
+    auto inputData = FileSystem::File{inputPath}.toBuffer();
+
+    if (inputData.empty())
+    {
+        std::cerr << "Unable to read " << inputPath << std::endl;
+        return false;
+    }
+
+    if (package::isPackage(inputData.data(), inputData.size()))
+    {
+        std::cerr << inputPath << " is already packaged" << std::endl;
+        return false;
+    }
+
+    auto outputData = package::encode(makeSegment(typeId, std::move(inputData)));
+    std::ofstream stream{outputPath, std::ios::binary};
+
+    if (!stream.write(reinterpret_cast<const char *>(outputData.data()),
+                      static_cast<std::streamsize>(outputData.size())))
+    {
+        std::cerr << "Unable to write " << outputPath << std::endl;
+        return false;
+    }
+
+    std::cout << inputPath << " -> " << outputPath << " (" << outputData.size() << " bytes)" << std::endl;
+
+    return true;
+}
+} // namespace
+
+auto main(int argc, char *argv[]) -> int
+{
+    if ((argc != 4) && (argc != 5))
+    {
+        printUsage();
+        return 1;
+    }
+
+    std::uint8_t typeId{};
+    auto type = to_lower(argv[1]);
+
+    if (type == "miv")
+    {
+        typeId = Chunk::Header::TypeId::Miv;
+    }
+    else if (type == "vpcc")
+    {
+        typeId = Chunk::Header::TypeId::Vpcc;
+    }
+    else
+    {
+        printUsage();
+        return 1;
+    }
+
+    try
+    {
+        if (argc == 4)
+        {
+            return packageFile(typeId, argv[2], argv[3]) ? 0 : 1;
+        }
+
+        auto nbSegment = std::stoi(argv[4]);
+
+        for (auto segmentId = 0; segmentId < nbSegment; segmentId++)
+        {
+            if (!packageFile(typeId, format(argv[2], segmentId), format(argv[3], segmentId)))
+            {
+                return 1;
+            }
+        }
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
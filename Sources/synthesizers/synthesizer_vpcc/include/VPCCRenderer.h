@@ -107,8 +107,8 @@ public:
     }
 
 protected:
-    //Metadata formatting
-    void formatMetadata(const std::unique_ptr<VpccMetadata>& metaData, const unsigned int tex_width, const unsigned int tex_height);
+    //Metadata upload, without any conversion
+    void uploadMetadata(const std::unique_ptr<VpccMetadata>& metaData, const unsigned int tex_width, const unsigned int tex_height);
     //Call all the glEnable stuff
     void enableRenderOptions();
     //Deactivate all the glEnable stuff
@@ -128,13 +128,9 @@ protected:
     size_t m_metaWidth{0};
     size_t m_metaHeight{0};
 
-    //Intermediate buffers
-    std::vector<float> m_bufferUV0UV1{};
-    std::vector<float> m_bufferD1NOP{};
-
     //Textures
-    Texture2D m_texUV0UV1;
-    Texture2D m_texD1NOP;
+    Texture2D m_texBlockToPatch;
+    Texture2D m_texPatchTable;
 
     float m_NOff{ 0 };
     float m_BOff{ 0 };
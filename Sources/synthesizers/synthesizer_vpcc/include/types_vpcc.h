@@ -27,14 +27,18 @@
 
 
 #include <iloj/gpu/texture.h>
+#include <cstdint>
+#include <memory>
 
 using HANDLE = void *;
 
 
-struct VpccPatchMetadata
+// Mirror of common/misc/types.h, see there for the binary layout
+constexpr std::uint32_t vpccMetadataLayoutVersion = 2;
+constexpr std::size_t vpccPatchTableWidth = 64;
+
+struct alignas(16) VpccPatchMetadata
 {
-    // public:
-    //uint16_t frame_index{0};
     uint16_t U0{0};
     uint16_t V0{0};
     uint16_t U1{0};
@@ -43,18 +47,18 @@ struct VpccPatchMetadata
     uint16_t NormalAxis{0};
     uint16_t PatchOrientation{0};
     uint16_t ProjectionMode{0};
-
-    // VpccPatchMetadata(){};
-    // VpccPatchMetadata(const VpccPatchMetadata &) = delete;
 };
 
+static_assert(sizeof(VpccPatchMetadata) == 16, "V-PCC patch table entries are two RGBA16UI texels");
+
 struct VpccMetadata
 {
+    std::uint32_t layout_version{vpccMetadataLayoutVersion};
     int frame_index{-1};
     int frame_width, frame_height;
-    //pcc::V3CParameterSet pccVps;
+    int patch_count{0};
     std::vector<VpccPatchMetadata> patchBlockBuffers = {};
-    std::vector<size_t> blockToPatch = {};
+    std::vector<std::uint16_t> blockToPatch = {};
 };
 
 struct GenericMetadata
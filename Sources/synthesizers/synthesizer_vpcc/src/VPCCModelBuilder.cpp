@@ -42,6 +42,25 @@ void VPCCModelBuilder::create_model_builder_program() {
 
     )DEF_SHADER";
 
+    // Patch of a block: tex_btp holds its index plus one (0 out of any patch), tex_patch the patch table, two texels
+    // per patch (see VpccMetadata)
+    static const std::string load_patch_src = R"DEF_SHADER(
+    uniform usampler2D tex_btp;
+    uniform usampler2D tex_patch;
+
+    void load_patch(ivec2 block, out vec4 u0v0_u1v1_t, out vec4 d1_norm_orient_proj_t) {
+        uint btp = texelFetch(tex_btp, min(block, textureSize(tex_btp, 0) - 1), 0).r;
+        int pid = max(int(btp) - 1, 0);
+        ivec2 texel = ivec2(2 * (pid % @patch_table_width), pid / @patch_table_width);
+        float valid = float(btp > 0u);
+        u0v0_u1v1_t = valid * vec4(texelFetch(tex_patch, texel, 0));
+        d1_norm_orient_proj_t = valid * vec4(texelFetch(tex_patch, texel + ivec2(1, 0), 0));
+    }
+    )DEF_SHADER";
+
+    const auto load_patch =
+        iloj::misc::replace(load_patch_src, {{"@patch_table_width", std::to_string(vpccPatchTableWidth)}});
+
     std::string shader_code;
     std::string shader_code_dd;
     //shader_code = LoadShader("modelBuilderDecimate.glsl");
@@ -57,8 +76,7 @@ void VPCCModelBuilder::create_model_builder_program() {
     uniform sampler2D tex_col;
     uniform sampler2D tex_geo;
     uniform sampler2D tex_ocm;
-    uniform sampler2D tex_uv0uv1;
-    uniform sampler2D tex_d1nop;
+    //@load_patch
     //@if_dynamic_decimation uniform usampler2D tex_dec;   
     //@if_global_decimation uniform uint decimation_level;
     uniform float N_off;
@@ -103,9 +121,10 @@ void VPCCModelBuilder::create_model_builder_program() {
             vec4 geo = textureLod(tex_geo, inv_uv.xy, 0.0);
     
 
-            //Load Metada
-            vec4 u0v0_u1v1_t = textureLod(tex_uv0uv1, uv.xy, 0.0);
-            vec4 d1_norm_orient_proj_t = textureLod(tex_d1nop, uv.xy, 0.0);
+            //Load Metadata
+            vec4 u0v0_u1v1_t;
+            vec4 d1_norm_orient_proj_t;
+            load_patch(ivec2(id / 16u), u0v0_u1v1_t, d1_norm_orient_proj_t);
 
             uint u0 = uint(u0v0_u1v1_t.x);
             uint v0 = uint(u0v0_u1v1_t.y);
@@ -160,8 +179,7 @@ void VPCCModelBuilder::create_model_builder_program() {
     uniform mat4 MVP;
     uniform float norm_res_factor;
     uniform sampler2D tex_geo;
-    uniform sampler2D tex_uv0uv1;
-    uniform sampler2D tex_d1nop;
+    //@load_patch
     uniform float r1;
     uniform float r2;
     uniform float vp_cull_factor;
@@ -189,9 +207,10 @@ void VPCCModelBuilder::create_model_builder_program() {
 
         vec4 geo = textureLod(tex_geo, inv_uv.xy, 0.0);
 
-        //Load Metada
-        vec4 u0v0_u1v1_t = textureLod(tex_uv0uv1, uv.xy, 0.0);
-        vec4 d1_norm_orient_proj_t = textureLod(tex_d1nop, uv.xy, 0.0);
+        //Load Metadata
+        vec4 u0v0_u1v1_t;
+        vec4 d1_norm_orient_proj_t;
+        load_patch(ivec2(id), u0v0_u1v1_t, d1_norm_orient_proj_t);
 
         uint u0 = uint(u0v0_u1v1_t.x);
         uint v0 = uint(u0v0_u1v1_t.y);
@@ -248,8 +267,7 @@ void VPCCModelBuilder::create_model_builder_program() {
     uniform mat4 MVP;
     uniform float norm_res_factor;
     uniform sampler2D tex_geo;
-    uniform sampler2D tex_uv0uv1;
-    uniform sampler2D tex_d1nop;
+    //@load_patch
     uniform float r1;
     uniform float r2;
     uniform float vp_cull_factor;
@@ -277,9 +295,10 @@ void VPCCModelBuilder::create_model_builder_program() {
 
         vec4 geo = textureLod(tex_geo, inv_uv.xy, 0.0);
 
-        //Load Metada
-        vec4 u0v0_u1v1_t = textureLod(tex_uv0uv1, uv.xy, 0.0);
-        vec4 d1_norm_orient_proj_t = textureLod(tex_d1nop, uv.xy, 0.0);
+        //Load Metadata
+        vec4 u0v0_u1v1_t;
+        vec4 d1_norm_orient_proj_t;
+        load_patch(ivec2(id), u0v0_u1v1_t, d1_norm_orient_proj_t);
 
         uint u0 = uint(u0v0_u1v1_t.x);
         uint v0 = uint(u0v0_u1v1_t.y);
@@ -334,6 +353,9 @@ void VPCCModelBuilder::create_model_builder_program() {
     )DEF_SHADER";
 #pragma endregion
 
+    shader_code = iloj::misc::replace(shader_code, {{"//@load_patch", load_patch}});
+    decimation_code_2 = iloj::misc::replace(decimation_code_2, {{"//@load_patch", load_patch}});
+
     m_compute_decimation_program = Program(decimation_code_2);
     //if (m_useDD) {
         //m_compute_decimation_program = Program(LoadShader("decimate.glsl"));
@@ -447,8 +469,8 @@ void VPCCModelBuilder::build_model(const Metadata& metaData,
         //LOG_INFO("Format Metadata");
         m_lastFrameId = metaData.VPCCMetadata->frame_index;
         // Getting the metadata
-        formatMetadata(metaData.VPCCMetadata, width, height);
-        LogError("Post Format Metadata");
+        uploadMetadata(metaData.VPCCMetadata, width, height);
+        LogError("Post Upload Metadata");
     }
 
     // Model building, done only once per video frame (except if forced)
@@ -478,8 +500,8 @@ void VPCCModelBuilder::build_model(const Metadata& metaData,
                 Uniform::Entry<float>("vp_cull_factor", m_vp_cull_factor),
                 Uniform::Entry<Mat4x4f>("MVP", m_MVP),
                 Uniform::Entry<Texture2D>("tex_geo", geometryMap),
-                Uniform::Entry<Texture2D>("tex_uv0uv1", m_texUV0UV1),
-                Uniform::Entry<Texture2D>("tex_d1nop", m_texD1NOP));
+                Uniform::Entry<Texture2D>("tex_btp", m_texBlockToPatch),
+                Uniform::Entry<Texture2D>("tex_patch", m_texPatchTable));
             LogError("Execute Decimation");
         }
 
@@ -517,8 +539,8 @@ void VPCCModelBuilder::build_model(const Metadata& metaData,
                 Uniform::Entry<Texture2D>("tex_col", textureMap),
                 Uniform::Entry<Texture2D>("tex_geo", geometryMap),
                 Uniform::Entry<Texture2D>("tex_ocm", occupancyMap),
-                Uniform::Entry<Texture2D>("tex_uv0uv1", m_texUV0UV1),
-                Uniform::Entry<Texture2D>("tex_d1nop", m_texD1NOP),
+                Uniform::Entry<Texture2D>("tex_btp", m_texBlockToPatch),
+                Uniform::Entry<Texture2D>("tex_patch", m_texPatchTable),
                 Uniform::Entry<GLuint>("vert_incr", GLuint(m_numVertPerPoint)),
                 Uniform::Entry<float>("norm_res_factor", norm_factor),
                 Uniform::Entry<int>("width", width),
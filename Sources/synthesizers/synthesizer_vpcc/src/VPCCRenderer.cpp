@@ -89,11 +89,18 @@ VPCCRenderer::VPCCRenderer(bool render_shadow, std::string name, bool count_poin
 }
 
 
-void VPCCRenderer::formatMetadata(const std::unique_ptr<VpccMetadata>& metadata,
+void VPCCRenderer::uploadMetadata(const std::unique_ptr<VpccMetadata>& metadata,
     const unsigned int tex_width,
     const unsigned int tex_height)
 {
+    if (metadata->layout_version != vpccMetadataLayoutVersion)
+    {
+        LOG_ERROR("VPCC Metadata layout version ", metadata->layout_version, " is not supported");
+        return;
+    }
+
     size_t size = metadata->blockToPatch.size();
+    size_t table_size = metadata->patchBlockBuffers.size();
     m_metaWidth = tex_width / 16;
     m_metaHeight = tex_height / 16;
 
@@ -108,73 +115,35 @@ void VPCCRenderer::formatMetadata(const std::unique_ptr<VpccMetadata>& metadata,
             " but we have ",
             size,
             " blocks ");
+        return;
     }
 
-    if (m_bufferUV0UV1.size() == 0 || m_bufferD1NOP.size() == 0)
-    {
-        m_bufferUV0UV1 = std::vector<float>(size * 4);
-        m_bufferD1NOP = std::vector<float>(size * 4);
-    }
-    if (m_bufferUV0UV1.size() < size * 4) // Resize only if too small to avoid reallocating every time.
-    {
-        m_bufferUV0UV1.resize(size * 4);
-        m_bufferD1NOP.resize(size * 4);     
-    }
-
-    auto& btp = metadata->blockToPatch;
-    auto& patchBlock = metadata->patchBlockBuffers;
-
-    for (size_t i = 0; i < size; i++)
+    if (table_size == 0 || table_size % vpccPatchTableWidth != 0)
     {
-        int patch = (btp[i] - 1);
-
-        uint16_t U0, V0, U1, V1, D1;
-        uint8_t norm, orient, proj;
-
-        if (patch >= 0)
-        {
-            U0 = patchBlock[patch].U0;
-            V0 = patchBlock[patch].V0;
-            U1 = patchBlock[patch].U1;
-            V1 = patchBlock[patch].V1;
-            D1 = patchBlock[patch].D1;
-            norm = patchBlock[patch].NormalAxis;
-            orient = patchBlock[patch].PatchOrientation;
-            proj = patchBlock[patch].ProjectionMode;
-
-            m_bufferUV0UV1[i * 4] = U0;
-            m_bufferUV0UV1[i * 4 + 1] = V0;
-            m_bufferUV0UV1[i * 4 + 2] = U1;
-            m_bufferUV0UV1[i * 4 + 3] = V1;
-
-            m_bufferD1NOP[i * 4] = D1;
-            m_bufferD1NOP[i * 4 + 1] = norm;
-            m_bufferD1NOP[i * 4 + 2] = orient;
-            m_bufferD1NOP[i * 4 + 3] = proj;
-
-        }
-        else
-        {
-            m_bufferUV0UV1[i * 4] = 0.0f;
-            m_bufferUV0UV1[i * 4 + 1] = 0.0f;
-            m_bufferUV0UV1[i * 4 + 2] = 0.0f;
-            m_bufferUV0UV1[i * 4 + 3] = 0.0f;
-
-            m_bufferD1NOP[i * 4] = 0.0f;
-            m_bufferD1NOP[i * 4 + 1] = 0.0f;
-            m_bufferD1NOP[i * 4 + 2] = 0.0f;
-            m_bufferD1NOP[i * 4 + 3] = 0.0f;
-        }
+        LOG_ERROR("VPCC patch table of ", table_size, " entries is not made of whole rows");
+        return;
     }
 
-    m_texUV0UV1.setContent(m_metaWidth, m_metaHeight, GL_RGBA32F, m_bufferUV0UV1.data(), GL_NEAREST, GL_CLAMP_TO_EDGE);
-    m_texD1NOP.setContent(m_metaWidth, m_metaHeight, GL_RGBA32F, m_bufferD1NOP.data(), GL_NEAREST, GL_CLAMP_TO_EDGE);
+    // Both are uploaded as laid out by the parser (see VpccMetadata)
+    m_texBlockToPatch.setContent(m_metaWidth,
+        m_metaHeight,
+        GL_R16UI,
+        metadata->blockToPatch.data(),
+        GL_NEAREST,
+        GL_CLAMP_TO_EDGE,
+        sizeof(std::uint16_t));
+    m_texPatchTable.setContent(2 * vpccPatchTableWidth,
+        table_size / vpccPatchTableWidth,
+        GL_RGBA16UI,
+        metadata->patchBlockBuffers.data(),
+        GL_NEAREST,
+        GL_CLAMP_TO_EDGE);
 }
 
 
 void VPCCRenderer::exportMetadata(const std::unique_ptr<VpccMetadata>& metadata)
 {
-    int num_patch = metadata->patchBlockBuffers.size();
+    int num_patch = metadata->patch_count;
     
     for (int pid = 0; pid < num_patch; pid++) {
 
@@ -48,7 +48,7 @@ extern "C" INTERFACE_EXPORT void INTERFACE_API OnCreateEvent(const char *configF
 
 extern "C" INTERFACE_EXPORT bool INTERFACE_API OnCapabilityEvent(const Metadata *metaData)
 {
-    return (metaData!=nullptr && metaData->VPCCMetadata->patchBlockBuffers.size() > 0);
+    return (metaData!=nullptr && metaData->VPCCMetadata->patch_count > 0);
 }
 
 extern "C" INTERFACE_EXPORT void INTERFACE_API OnRenderEvent(const Metadata *metaData,